@@ -12,6 +12,7 @@
 #include "Engine/UserInput/UserInput.h"
 #include "Engine/Physics/PhysicsSimulation.h"
 #include "Engine/GameCommon/GameplayUtility.h"
+#include "Engine/GameCommon/DebugDraw.h"
 #include "Engine/Math/EigenHelper.h"
 
 // Interface
@@ -23,6 +24,8 @@ int sca2025::Application::argc = 0;
 void sca2025::Application::cbApplication::UpdateSimulationBasedOnTime(const double i_elapsedSecondCount_sinceLastUpdate)
 {
 	size_t size_physicsObject = colliderObjects.size();
+	//debug primitives are redrawn by every update
+	DebugDraw::Clear();
 	// ***********************run physics****************************************************	
 			//update game objects with AABB
 	Physics::RunPhysics(colliderObjects, noColliderObjects, static_cast<float>(i_elapsedSecondCount_sinceLastUpdate));
@@ -125,6 +128,9 @@ void sca2025::Application::cbApplication::SubmitDataToBeRendered(const float i_e
 		}
 	}
 
+	//submit debug primitives
+	DebugDraw::Submit();
+
 	//submit camera
 	if (!Graphics::renderThreadNoWait)
 	{
@@ -142,12 +148,12 @@ sca2025::cResult sca2025::Application::cbApplication::CleanUp()
 	//release all game objects first
 	size_t numOfObjects = colliderObjects.size();
 	for (size_t i = 0; i < numOfObjects; i++) {
-		delete colliderObjects[i];
+		GameCommon::DeleteGameObject(colliderObjects[i]);
 	}
 	colliderObjects.clear();
 	numOfObjects = noColliderObjects.size();
 	for (size_t i = 0; i < numOfObjects; i++) {
-		delete noColliderObjects[i];
+		GameCommon::DeleteGameObject(noColliderObjects[i]);
 	}
 	noColliderObjects.clear();
 
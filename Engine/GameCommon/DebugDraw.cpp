@@ -0,0 +1,136 @@
+#include "DebugDraw.h"
+#include "GameplayUtility.h"
+#include "Engine/Graphics/Graphics.h"
+#include "Engine/Math/cMatrix_transformation.h"
+#include <Engine/Concurrency/cMutex.h>
+#include <memory>
+#include <cmath>
+
+namespace sca2025
+{
+	namespace DebugDraw
+	{
+		sca2025::Assets::cHandle<Mesh> lineMesh;
+
+		namespace
+		{
+			struct ThreadBuffer {
+				std::vector<Math::cMatrix_transformation> lineTransforms;
+				std::vector<Math::sVector> lineColors;
+				std::vector<Math::cMatrix_transformation> arrowTransforms;
+				std::vector<Math::sVector> arrowColors;
+			};
+
+			//buffers live until exit, the mutex is only taken the first time a thread draws
+			std::vector<std::unique_ptr<ThreadBuffer>> threadBuffers;
+			Concurrency::cMutex threadBufferMutex;
+			//gathered buffers of every thread, kept between frames to reuse the capacity
+			std::vector<Math::cMatrix_transformation> submitTransforms;
+			std::vector<Math::sVector> submitColors;
+
+			ThreadBuffer& GetThreadBuffer()
+			{
+				thread_local ThreadBuffer* pBuffer = nullptr;
+				if (!pBuffer)
+				{
+					threadBufferMutex.Lock();
+					threadBuffers.push_back(std::unique_ptr<ThreadBuffer>(new ThreadBuffer()));
+					pBuffer = threadBuffers.back().get();
+					threadBufferMutex.Unlock();
+				}
+				return *pBuffer;
+			}
+
+			//local y axis along i_axis with its length times i_scaleY, x and z scaled by i_scaleX and i_scaleZ
+			Math::cMatrix_transformation AlignYAxis(const Vector3d& i_origin, const Vector3d& i_axis, double i_scaleX, double i_scaleY, double i_scaleZ)
+			{
+				Vector3d y = i_axis.normalized();
+				Vector3d x = std::abs(y(0)) < 0.9 ? Vector3d(1, 0, 0).cross(y).normalized() : Vector3d(0, 0, 1).cross(y).normalized();
+				Vector3d z = x.cross(y);
+				x *= i_scaleX;
+				y *= i_scaleY;
+				z *= i_scaleZ;
+
+				Math::cMatrix_transformation m;
+				m.m_00 = static_cast<float>(x(0)); m.m_01 = static_cast<float>(y(0)); m.m_02 = static_cast<float>(z(0));
+				m.m_10 = static_cast<float>(x(1)); m.m_11 = static_cast<float>(y(1)); m.m_12 = static_cast<float>(z(1));
+				m.m_20 = static_cast<float>(x(2)); m.m_21 = static_cast<float>(y(2)); m.m_22 = static_cast<float>(z(2));
+				m.m_03 = static_cast<float>(i_origin(0));
+				m.m_13 = static_cast<float>(i_origin(1));
+				m.m_23 = static_cast<float>(i_origin(2));
+				return m;
+			}
+
+			void SubmitGathered(std::vector<Math::cMatrix_transformation> ThreadBuffer::* i_transforms, std::vector<Math::sVector> ThreadBuffer::* i_colors, Mesh* i_pMesh)
+			{
+				submitTransforms.clear();
+				submitColors.clear();
+				for (size_t t = 0; t < threadBuffers.size(); t++)
+				{
+					ThreadBuffer& buffer = *threadBuffers[t];
+					submitTransforms.insert(submitTransforms.end(), (buffer.*i_transforms).begin(), (buffer.*i_transforms).end());
+					submitColors.insert(submitColors.end(), (buffer.*i_colors).begin(), (buffer.*i_colors).end());
+				}
+				if (submitTransforms.empty()) return;
+				Graphics::SubmitDebugBatch(submitColors.data(), submitTransforms.data(), submitTransforms.size(), defaultEffect, i_pMesh);
+			}
+		}
+
+		void DrawLine(Vector3d from, Vector3d to, Math::sVector color, double thickness)
+		{
+			Vector3d d = to - from;
+			double length = d.norm();
+			if (length <= 0.0) return;
+			ThreadBuffer& buffer = GetThreadBuffer();
+			if (lineMesh)
+			{
+				//the cube spans -1 to 1
+				buffer.lineTransforms.push_back(AlignYAxis(0.5 * (from + to), d, 0.5 * thickness, 0.5 * length, 0.5 * thickness));
+				buffer.lineColors.push_back(color);
+			}
+			else
+			{
+				buffer.arrowTransforms.push_back(AlignYAxis(from, d, thickness, length, thickness));
+				buffer.arrowColors.push_back(color);
+			}
+		}
+
+		void DrawArrow(Vector3d startPoint, Vector3d dir, Math::sVector color, Vector3d scaling)
+		{
+			if (dir.squaredNorm() <= 0.0) return;
+			ThreadBuffer& buffer = GetThreadBuffer();
+			buffer.arrowTransforms.push_back(AlignYAxis(startPoint, dir, scaling(0), scaling(1), scaling(2)));
+			buffer.arrowColors.push_back(color);
+		}
+
+		void DrawAxes(Vector3d pos, double scaling)
+		{
+			Vector3d s(scaling, scaling, scaling);
+			DrawArrow(pos, Vector3d(1, 0, 0), Math::sVector(1.0, 0.0, 0.0), s);
+			DrawArrow(pos, Vector3d(0, 1, 0), Math::sVector(0.0, 1.0, 0.0), s);
+			DrawArrow(pos, Vector3d(0, 0, 1), Math::sVector(0.0, 0.0, 1.0), s);
+		}
+
+		void Clear()
+		{
+			threadBufferMutex.Lock();
+			for (size_t t = 0; t < threadBuffers.size(); t++)
+			{
+				ThreadBuffer& buffer = *threadBuffers[t];
+				buffer.lineTransforms.clear();
+				buffer.lineColors.clear();
+				buffer.arrowTransforms.clear();
+				buffer.arrowColors.clear();
+			}
+			threadBufferMutex.Unlock();
+		}
+
+		void Submit()
+		{
+			threadBufferMutex.Lock();
+			if (lineMesh) SubmitGathered(&ThreadBuffer::lineTransforms, &ThreadBuffer::lineColors, Mesh::s_manager.Get(lineMesh));
+			if (GameplayUtility::arrowMesh) SubmitGathered(&ThreadBuffer::arrowTransforms, &ThreadBuffer::arrowColors, Mesh::s_manager.Get(GameplayUtility::arrowMesh));
+			threadBufferMutex.Unlock();
+		}
+	}
+}
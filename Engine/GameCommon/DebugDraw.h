@@ -0,0 +1,24 @@
+#pragma once
+#include "Engine/Math/sVector.h"
+#include "Engine/Graphics/Mesh.h"
+#include "External/EigenLibrary/Eigen/Dense"
+
+using namespace Eigen;
+namespace sca2025
+{
+	//immediate mode debug drawing, nothing is created or locked per primitive
+	//every thread appends to its own buffer, the buffers are emptied when a simulation update starts
+	//and submitted to Graphics as one batch per mesh each frame, so primitives stay visible until the next update
+	namespace DebugDraw
+	{
+		extern sca2025::Assets::cHandle<Mesh> lineMesh;//a -1 to 1 cube, lines fall back to the arrow mesh when not set
+
+		void DrawLine(Vector3d from, Vector3d to, Math::sVector color, double thickness = 0.02);
+		void DrawArrow(Vector3d startPoint, Vector3d dir, Math::sVector color, Vector3d scaling);
+		void DrawAxes(Vector3d pos, double scaling);
+
+		//called by the application, not from the simulation
+		void Clear();
+		void Submit();
+	}
+}
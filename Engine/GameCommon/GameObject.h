@@ -89,6 +89,7 @@ namespace sca2025 {
 			virtual void Tick(const float i_secondCountToIntegrate) {}//deprecated
 			virtual void Tick(const double i_secondCountToIntegrate) {}
 			virtual void OnHit(GameObject * i_pObjectHit) {}
+			//called for every overlapping pair when the frame starts, and again for the pairs of both bodies after each resolved collision
 			virtual void OnOverlap(GameObject * i_pObjectOverlapped) {}
 			//In renderThreadNoWait mode, users are not allowed to add new game objects within UpdateGameObjectBasedOnInput
 			virtual void UpdateGameObjectBasedOnInput() {}
@@ -127,10 +128,15 @@ namespace sca2025 {
 			sca2025::Assets::cHandle<Mesh> m_Mesh;
 			Effect* m_pEffect = nullptr;
 			bool active = true;
+			int poolIndex = -1;//slot in gameObjectPool, -1 for objects created with new
+			friend class GameObjectPool;
 		};	
 	
 		class Camera;
+		//releases the inactive objects in one pass, called once per frame
 		void RemoveInactiveGameObjects(std::vector<GameObject *> & o_allGameObjects);
+		//returns pooled objects to gameObjectPool and deletes the others
+		void DeleteGameObject(GameObject * i_pGameObject);
 		void ResetAllGameObjectsVelo(std::vector<GameObject *> & o_gameObjectsWithCollider, std::vector<GameObject *> & o_gameObjectsWithoutCollider, Camera & o_camera);
 	}
 }
\ No newline at end of file
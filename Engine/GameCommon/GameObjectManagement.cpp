@@ -1,4 +1,5 @@
 #include "GameObject.h"
+#include "GameObjectPool.h"
 #include "Camera.h"
 namespace sca2025 {
 	std::vector<GameCommon::GameObject *> colliderObjects;//game objects with colliders
@@ -7,14 +8,25 @@ namespace sca2025 {
 
 	namespace GameCommon {
 		void RemoveInactiveGameObjects(std::vector<GameObject *> & o_allGameObjects) {
+			//compact the active objects to the front, the capacity is kept for the next frame
+			size_t numActive = 0;
 			for (size_t i = 0; i < o_allGameObjects.size(); i++) {
 				if (o_allGameObjects[i]->isActive() == false) {
-					delete o_allGameObjects[i];
-					o_allGameObjects[i] = o_allGameObjects.back();
-					o_allGameObjects.pop_back();
-					o_allGameObjects.shrink_to_fit();
-					i--;
+					DeleteGameObject(o_allGameObjects[i]);
 				}
+				else {
+					o_allGameObjects[numActive++] = o_allGameObjects[i];
+				}
+			}
+			o_allGameObjects.resize(numActive);
+		}
+
+		void DeleteGameObject(GameObject * i_pGameObject) {
+			if (GameObjectPool::IsPooled(i_pGameObject)) {
+				gameObjectPool.Release(i_pGameObject);
+			}
+			else {
+				delete i_pGameObject;
 			}
 		}
 
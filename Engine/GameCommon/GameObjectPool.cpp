@@ -0,0 +1,71 @@
+#include "GameObjectPool.h"
+#include <new>
+
+namespace sca2025 {
+	namespace GameCommon {
+		GameObjectPool gameObjectPool;
+
+		GameObjectHandle GameObjectPool::Create(Effect * i_pEffect, sca2025::Assets::cHandle<Mesh> i_Mesh, Physics::sRigidBodyState i_State)
+		{
+			poolMutex.Lock();
+			if (firstFree < 0)
+			{
+				//chain a new chunk into the free list
+				int start = static_cast<int>(chunks.size()) * CHUNK_SIZE;
+				chunks.push_back(std::unique_ptr<Slot[]>(new Slot[CHUNK_SIZE]));
+				for (int i = 0; i < CHUNK_SIZE; i++)
+				{
+					chunks.back()[i].nextFree = i + 1 < CHUNK_SIZE ? start + i + 1 : -1;
+				}
+				firstFree = start;
+			}
+			uint32_t index = static_cast<uint32_t>(firstFree);
+			Slot* pSlot = GetSlot(index);
+			firstFree = pSlot->nextFree;
+			pSlot->used = true;
+			numObjects++;
+			GameObjectHandle handle;
+			handle.index = index;
+			handle.generation = pSlot->generation;
+			poolMutex.Unlock();
+
+			//the constructor registers the object in the game object arrays, which takes gameObjectArrayMutex
+			GameObject* pGameObject = new (pSlot->storage) GameObject(i_pEffect, i_Mesh, i_State);
+			pGameObject->poolIndex = static_cast<int>(index);
+			return handle;
+		}
+
+		GameObject* GameObjectPool::Get(GameObjectHandle i_handle)
+		{
+			GameObject* pGameObject = nullptr;
+			poolMutex.Lock();
+			if (i_handle.index != UINT32_MAX && i_handle.index < chunks.size() * CHUNK_SIZE)
+			{
+				Slot* pSlot = GetSlot(i_handle.index);
+				if (pSlot->used && pSlot->generation == i_handle.generation) pGameObject = pSlot->Object();
+			}
+			poolMutex.Unlock();
+			return pGameObject && pGameObject->isActive() ? pGameObject : nullptr;
+		}
+
+		void GameObjectPool::Destroy(GameObjectHandle i_handle)
+		{
+			GameObject* pGameObject = Get(i_handle);
+			if (pGameObject) pGameObject->DestroyGameObject();
+		}
+
+		void GameObjectPool::Release(GameObject* i_pGameObject)
+		{
+			uint32_t index = static_cast<uint32_t>(i_pGameObject->poolIndex);
+			i_pGameObject->~GameObject();
+			poolMutex.Lock();
+			Slot* pSlot = GetSlot(index);
+			pSlot->used = false;
+			pSlot->generation++;
+			pSlot->nextFree = firstFree;
+			firstFree = static_cast<int>(index);
+			numObjects--;
+			poolMutex.Unlock();
+		}
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include "GameObject.h"
+
+namespace sca2025 {
+	namespace GameCommon {
+		//reference to a pooled game object, it goes stale once the object is destroyed and its slot is reused
+		struct GameObjectHandle {
+			uint32_t index = UINT32_MAX;
+			uint32_t generation = 0;
+		};
+
+		//fixed size chunks of game object slots, objects never move so raw pointers stay valid until the object is released
+		//destroying only deactivates, RemoveInactiveGameObjects releases the slots at the end of the frame
+		class GameObjectPool {
+		public:
+			GameObjectHandle Create(Effect * i_pEffect, sca2025::Assets::cHandle<Mesh> i_Mesh, Physics::sRigidBodyState i_State);
+			//nullptr for stale handles and objects waiting to be released
+			GameObject* Get(GameObjectHandle i_handle);
+			void Destroy(GameObjectHandle i_handle);
+			//runs the destructor and frees the slot, only called for objects created by the pool
+			void Release(GameObject* i_pGameObject);
+			static bool IsPooled(GameObject* i_pGameObject) { return i_pGameObject->poolIndex >= 0; }
+			size_t GetObjectCount() { return numObjects; }
+
+		private:
+			struct Slot {
+				alignas(GameObject) unsigned char storage[sizeof(GameObject)];
+				uint32_t generation = 0;
+				int nextFree = -1;
+				bool used = false;
+				GameObject* Object() { return reinterpret_cast<GameObject*>(storage); }
+			};
+			static const int CHUNK_SIZE = 64;
+			Slot* GetSlot(uint32_t i_index) { return &chunks[i_index / CHUNK_SIZE][i_index % CHUNK_SIZE]; }
+
+			std::vector<std::unique_ptr<Slot[]>> chunks;
+			int firstFree = -1;
+			size_t numObjects = 0;
+			Concurrency::cMutex poolMutex;
+		};
+
+		extern GameObjectPool gameObjectPool;
+	}
+}
@@ -38,12 +38,12 @@ namespace sca2025
 			return output;
 		}
 
-		GameCommon::GameObject* DrawArrow(Vector3d startPoint, Vector3d dir, Math::sVector color, double scaling)
+		GameCommon::GameObjectHandle DrawArrow(Vector3d startPoint, Vector3d dir, Math::sVector color, double scaling)
 		{
 			return DrawArrowScaled(startPoint, dir, color, Vector3d(scaling, scaling, scaling));
 		}
 
-		GameCommon::GameObject* DrawArrowScaled(Vector3d startPoint, Vector3d dir, Math::sVector color, Vector3d scaling)
+		GameCommon::GameObjectHandle DrawArrowScaled(Vector3d startPoint, Vector3d dir, Math::sVector color, Vector3d scaling)
 		{
 			//get arrow transform
 			dir.normalize();
@@ -65,13 +65,14 @@ namespace sca2025
 				rotMatEigen.setIdentity();
 			}
 			//creat game object
-			GameCommon::GameObject *pGameObject = new GameCommon::GameObject(defaultEffect, arrowMesh, Physics::sRigidBodyState());
+			GameCommon::GameObjectHandle handle = GameCommon::gameObjectPool.Create(defaultEffect, arrowMesh, Physics::sRigidBodyState());
+			GameCommon::GameObject *pGameObject = GameCommon::gameObjectPool.Get(handle);
 			pGameObject->scale = scaling;
 			pGameObject->m_State.position = Math::EigenVector2nativeVector(startPoint);
 			pGameObject->m_State.orientation = Math::ConvertEigenQuatToNativeQuat(Math::RotationConversion_MatToQuat(rotMatEigen));
 			pGameObject->m_color = color;
 
-			return pGameObject;
+			return handle;
 		}
 
 		void DrawXYZCoordinate(Vector3d pos)
@@ -1,5 +1,6 @@
 #pragma once
 #include "Engine/Math/sVector.h"
+#include "GameObjectPool.h"
 
 namespace sca2025
 {
@@ -14,8 +15,9 @@ namespace sca2025
 		extern sca2025::Assets::cHandle<Mesh> arrowMesh;
 
 		Math::sVector MouseRayCasting();
-		GameCommon::GameObject* DrawArrow(Vector3d startPoint, Vector3d dir, Math::sVector color, double scaling);
-		GameCommon::GameObject* DrawArrowScaled(Vector3d startPoint, Vector3d dir, Math::sVector color, Vector3d scaling);
+		//arrows are pooled game objects, destroy them through gameObjectPool
+		GameCommon::GameObjectHandle DrawArrow(Vector3d startPoint, Vector3d dir, Math::sVector color, double scaling);
+		GameCommon::GameObjectHandle DrawArrowScaled(Vector3d startPoint, Vector3d dir, Math::sVector color, Vector3d scaling);
 		void DrawXYZCoordinate(Vector3d pos);
 	}
 }
\ No newline at end of file
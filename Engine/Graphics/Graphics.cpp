@@ -17,6 +17,7 @@
 #include <Engine/Time/Time.h>
 #include <Engine/UserOutput/UserOutput.h>
 #include "Engine/UserInput/UserInput.h"
+#include <algorithm>
 #include <utility>
 
 #include "Mesh.h"
@@ -28,6 +29,8 @@
 // Static Data Initialization
 //===========================
 #define maxNumActors 7000
+#define maxNumDebugInstances 8192
+#define maxNumDebugBatches 16
 namespace sca2025
 {
 	namespace Graphics
@@ -63,6 +66,12 @@ namespace
 		Mesh* allMeshInScreen[maxNumActors];
 		//uint16_t EMCounter = 0;//use to initilize effect and mesh array above;
 		uint16_t numberOfObject = 0;
+		//debug draw batches, batch i covers the instances from the end of batch i - 1 to debugBatchEnd[i]
+		sca2025::Graphics::ConstantBufferFormats::sPerDrawCall constantData_debugDrawCall[maxNumDebugInstances];
+		Effect* debugBatchEffect[maxNumDebugBatches];
+		Mesh* debugBatchMesh[maxNumDebugBatches];
+		uint16_t debugBatchEnd[maxNumDebugBatches];
+		uint16_t numberOfDebugBatch = 0;
 	};
 	// In our class there will be two copies of the data required to render a frame:
 	//	* One of them will be getting populated by the data currently being submitted by the application loop thread
@@ -83,6 +92,18 @@ namespace
 	sca2025::Concurrency::cEvent s_whenDataForANewFrameCanBeSubmittedFromApplicationThread;
 	
 	View s_View;
+
+	void ClearDebugBatches(sDataRequiredToRenderAFrame* io_data)
+	{
+		for (int i = 0; i < io_data->numberOfDebugBatch; i++) {
+			io_data->debugBatchEffect[i]->DecrementReferenceCount();
+			io_data->debugBatchEffect[i] = nullptr;
+
+			io_data->debugBatchMesh[i]->DecrementReferenceCount();
+			io_data->debugBatchMesh[i] = nullptr;
+		}
+		io_data->numberOfDebugBatch = 0;
+	}
 }
 //************************************************cache data from application*********************************
 void sca2025::Graphics::SubmitElapsedTime(const float i_elapsedSecondCount_systemTime, const float i_elapsedSecondCount_simulationTime)
@@ -122,6 +143,25 @@ void sca2025::Graphics::SubmitObject(Math::sVector i_color, Math::cMatrix_transf
 	}
 }
 
+void sca2025::Graphics::SubmitDebugBatch(const Math::sVector *i_colors, const Math::cMatrix_transformation *i_localToWorldMats, size_t i_count, Effect *i_pEffect, Mesh * i_pMesh) {
+	auto* data = s_dataBeingSubmittedByApplicationThread;
+	if (i_count == 0 || data->numberOfDebugBatch >= maxNumDebugBatches) return;
+	size_t first = data->numberOfDebugBatch > 0 ? data->debugBatchEnd[data->numberOfDebugBatch - 1] : 0;
+	size_t count = std::min(i_count, static_cast<size_t>(maxNumDebugInstances) - first);
+	if (count == 0) return;
+	for (size_t i = 0; i < count; i++) {
+		data->constantData_debugDrawCall[first + i].g_transform_localToWorld = i_localToWorldMats[i];
+		data->constantData_debugDrawCall[first + i].g_color = i_colors[i];
+	}
+
+	i_pEffect->IncrementReferenceCount();
+	data->debugBatchEffect[data->numberOfDebugBatch] = i_pEffect;
+	i_pMesh->IncrementReferenceCount();
+	data->debugBatchMesh[data->numberOfDebugBatch] = i_pMesh;
+	data->debugBatchEnd[data->numberOfDebugBatch] = static_cast<uint16_t>(first + count);
+	data->numberOfDebugBatch++;
+}
+
 //*******************************************************************************************************************
 sca2025::cResult sca2025::Graphics::WaitUntilDataForANewFrameCanBeSubmitted(const unsigned int i_timeToWait_inMilliseconds)
 {
@@ -228,6 +268,18 @@ void sca2025::Graphics::RenderFrame()
 		// Draw the geometry
 		s_dataBeingRenderedByRenderThread->allMeshInScreen[i]->Draw();
 	}
+	//debug draw batches bind their effect once
+	{
+		int first = 0;
+		for (int b = 0; b < s_dataBeingRenderedByRenderThread->numberOfDebugBatch; b++) {
+			s_dataBeingRenderedByRenderThread->debugBatchEffect[b]->Bind();
+			for (int i = first; i < s_dataBeingRenderedByRenderThread->debugBatchEnd[b]; i++) {
+				s_constantBuffer_perDrawCall.Update(&s_dataBeingRenderedByRenderThread->constantData_debugDrawCall[i]);
+				s_dataBeingRenderedByRenderThread->debugBatchMesh[b]->Draw();
+			}
+			first = s_dataBeingRenderedByRenderThread->debugBatchEnd[b];
+		}
+	}
 
 	// Everything has been drawn to the "back buffer", which is just an image in memory.
 	// In order to display it the contents of the back buffer must be "presented"
@@ -250,6 +302,7 @@ void sca2025::Graphics::RenderFrame()
 			s_dataBeingRenderedByRenderThread->allMeshInScreen[i] = nullptr;
 		}
 		s_dataBeingRenderedByRenderThread->numberOfObject = 0;
+		ClearDebugBatches(s_dataBeingRenderedByRenderThread);
 		s_dataBeingRenderedByRenderThread->BGColor[0] = 0;
 		s_dataBeingRenderedByRenderThread->BGColor[1] = 0;
 		s_dataBeingRenderedByRenderThread->BGColor[2] = 0;
@@ -292,6 +345,7 @@ void sca2025::Graphics::ClearDataBeingSubmittedByApplicationThread()
 			s_dataBeingSubmittedByApplicationThread->allMeshInScreen[i] = nullptr;
 		}
 		s_dataBeingSubmittedByApplicationThread->numberOfObject = 0;
+		ClearDebugBatches(s_dataBeingSubmittedByApplicationThread);
 		s_dataBeingSubmittedByApplicationThread->BGColor[0] = 0;
 		s_dataBeingSubmittedByApplicationThread->BGColor[1] = 0;
 		s_dataBeingSubmittedByApplicationThread->BGColor[2] = 0;
@@ -42,6 +42,8 @@ namespace sca2025
 		void SubmitElapsedTime( const float i_elapsedSecondCount_systemTime, const float i_elapsedSecondCount_simulationTime );
 		void SubmitBGColor(const float *i_color);
 		void SubmitObject(Math::sVector i_color, Math::cMatrix_transformation &i_localToWorldMat, Effect *i_pEffect, Mesh * i_pMesh);
+		//instances of one mesh drawn after the objects, the effect and mesh are referenced once for the whole batch
+		void SubmitDebugBatch(const Math::sVector *i_colors, const Math::cMatrix_transformation *i_localToWorldMats, size_t i_count, Effect *i_pEffect, Mesh * i_pMesh);
 		void SubmitCamera(Math::cMatrix_transformation &i_transform_worldToCamera, Math::cMatrix_transformation &i_transform_cameraToProjected);
 
 		// When the application is ready to submit data for a new frame
@@ -0,0 +1,155 @@
+#include <cmath>
+#include <algorithm>
+
+#include "Broadphase.h"
+#include "Engine/Physics/sRigidBodyState.h"
+#include "Engine/GameCommon/GameObject.h"
+#include "Engine/Math/cMatrix_transformation.h"
+
+namespace sca2025 {
+	namespace Physics {
+		std::vector<BroadphasePair> broadphasePairs;
+		float broadphaseMargin = 0.05f;
+
+		namespace {
+			std::vector<AABB> worldBoxes;
+			std::vector<int> sortedIndices;//persistent between frames for temporal coherence
+
+			float AxisValue(const Math::sVector& i_v, int i_axis)
+			{
+				if (i_axis == 0) return i_v.x;
+				if (i_axis == 1) return i_v.y;
+				return i_v.z;
+			}
+		}
+
+		AABB ComputeWorldAABB(sRigidBodyState& i_state)
+		{
+			AABB worldBox;
+			Collider& collider = i_state.collider;
+			if (collider.m_type == Plane)
+			{
+				//planes are unbounded, they overlap everything
+				worldBox.center = collider.m_transformation * collider.m_hull->vertices[0];
+				worldBox.extends = Math::sVector(1.0e30f, 1.0e30f, 1.0e30f);
+				return worldBox;
+			}
+			else if (collider.m_type == TriMesh && collider.m_mesh)
+			{
+				AABB localBox;
+				localBox.center = (collider.m_mesh->boundsMin + collider.m_mesh->boundsMax) * 0.5f;
+				localBox.extends = (collider.m_mesh->boundsMax - collider.m_mesh->boundsMin) * 0.5f;
+				Math::cMatrix_transformation& m = collider.m_transformation;
+				worldBox.center = m * localBox.center;
+				Math::sVector& e = localBox.extends;
+				worldBox.extends.x = std::abs(m.m_00) * e.x + std::abs(m.m_01) * e.y + std::abs(m.m_02) * e.z;
+				worldBox.extends.y = std::abs(m.m_10) * e.x + std::abs(m.m_11) * e.y + std::abs(m.m_12) * e.z;
+				worldBox.extends.z = std::abs(m.m_20) * e.x + std::abs(m.m_21) * e.y + std::abs(m.m_22) * e.z;
+			}
+			else if (collider.m_type == Sphere && collider.m_hull->vertices.size() > 1)
+			{
+				float r = collider.m_hull->vertices[1].GetLength();
+				worldBox.center = collider.m_transformation * collider.m_hull->vertices[0];
+				worldBox.extends = Math::sVector(r, r, r);
+			}
+			else
+			{
+				AABB localBox = i_state.boundingBox;
+				if (localBox.extends.GetLengthSQ() <= 0.0f)
+				{
+					//bounding box is not set, fall back to the box of the collider hull
+					localBox.center = collider.m_hull->boxCenter;
+					localBox.extends = collider.m_hull->boxExtends;
+				}
+				Math::cMatrix_transformation rot(i_state.orientation, Math::sVector(0.0f, 0.0f, 0.0f));
+				worldBox.center = i_state.position + rot * localBox.center;
+				//extents of the rotated box are |R| * extents
+				Math::sVector& e = localBox.extends;
+				worldBox.extends.x = std::abs(rot.m_00) * e.x + std::abs(rot.m_01) * e.y + std::abs(rot.m_02) * e.z;
+				worldBox.extends.y = std::abs(rot.m_10) * e.x + std::abs(rot.m_11) * e.y + std::abs(rot.m_12) * e.z;
+				worldBox.extends.z = std::abs(rot.m_20) * e.x + std::abs(rot.m_21) * e.y + std::abs(rot.m_22) * e.z;
+			}
+			worldBox.extends += Math::sVector(broadphaseMargin, broadphaseMargin, broadphaseMargin);
+			return worldBox;
+		}
+
+		bool AABBOverlap(const AABB& i_a, const AABB& i_b)
+		{
+			Math::sVector d = i_a.center - i_b.center;
+			Math::sVector e = i_a.extends + i_b.extends;
+			return std::abs(d.x) <= e.x && std::abs(d.y) <= e.y && std::abs(d.z) <= e.z;
+		}
+
+		void SweepAndPrune(std::vector<GameCommon::GameObject *> & i_colliderObjects, std::vector<BroadphasePair>& o_pairs)
+		{
+			o_pairs.clear();
+			int n = static_cast<int>(i_colliderObjects.size());
+			worldBoxes.resize(n);
+
+			//sweep along the axis with the largest variance of box centers
+			Math::sVector mean, meanSQ;
+			for (int i = 0; i < n; i++)
+			{
+				worldBoxes[i] = ComputeWorldAABB(i_colliderObjects[i]->m_State);
+				Math::sVector& c = worldBoxes[i].center;
+				mean += c;
+				meanSQ += Math::sVector(c.x * c.x, c.y * c.y, c.z * c.z);
+			}
+			int axis = 0;
+			if (n > 0)
+			{
+				mean /= float(n);
+				meanSQ /= float(n);
+				Math::sVector variance = meanSQ - Math::sVector(mean.x * mean.x, mean.y * mean.y, mean.z * mean.z);
+				if (variance.y > variance.x) axis = 1;
+				if (variance.z > AxisValue(variance, axis)) axis = 2;
+			}
+
+			//objects were added or removed, restart from the identity order
+			if (static_cast<int>(sortedIndices.size()) != n)
+			{
+				sortedIndices.resize(n);
+				for (int i = 0; i < n; i++) sortedIndices[i] = i;
+			}
+
+			//insertion sort on the interval start, nearly sorted from the previous frame
+			for (int i = 1; i < n; i++)
+			{
+				int index = sortedIndices[i];
+				float key = AxisValue(worldBoxes[index].center, axis) - AxisValue(worldBoxes[index].extends, axis);
+				int j = i - 1;
+				while (j >= 0 && AxisValue(worldBoxes[sortedIndices[j]].center, axis) - AxisValue(worldBoxes[sortedIndices[j]].extends, axis) > key)
+				{
+					sortedIndices[j + 1] = sortedIndices[j];
+					j--;
+				}
+				sortedIndices[j + 1] = index;
+			}
+
+			//sweep
+			for (int i = 0; i < n; i++)
+			{
+				int indexA = sortedIndices[i];
+				sRigidBodyState& stateA = i_colliderObjects[indexA]->m_State;
+				float maxA = AxisValue(worldBoxes[indexA].center, axis) + AxisValue(worldBoxes[indexA].extends, axis);
+				for (int j = i + 1; j < n; j++)
+				{
+					int indexB = sortedIndices[j];
+					if (AxisValue(worldBoxes[indexB].center, axis) - AxisValue(worldBoxes[indexB].extends, axis) > maxA) break;
+					if (stateA.isStatic && i_colliderObjects[indexB]->m_State.isStatic) continue;
+					if (!AABBOverlap(worldBoxes[indexA], worldBoxes[indexB])) continue;
+
+					BroadphasePair pair;
+					pair.indexA = std::min(indexA, indexB);
+					pair.indexB = std::max(indexA, indexB);
+					o_pairs.push_back(pair);
+				}
+			}
+
+			//keep the same pair order as the brute force loop so the solver order is deterministic
+			std::sort(o_pairs.begin(), o_pairs.end(), [](const BroadphasePair& a, const BroadphasePair& b) {
+				return a.indexA < b.indexA || (a.indexA == b.indexA && a.indexB < b.indexB);
+			});
+		}
+	}
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include "CollisionHelpers.h"
+#include <vector>
+
+namespace sca2025 {
+	namespace GameCommon {
+		class GameObject;
+	}
+	namespace Physics {
+		struct sRigidBodyState;
+
+		//indices into the collider object array, indexA < indexB
+		struct BroadphasePair {
+			int indexA;
+			int indexB;
+		};
+
+		extern std::vector<BroadphasePair> broadphasePairs;
+		extern float broadphaseMargin;//world AABBs are fattened by this amount so resting contacts stay in the pair list
+
+		AABB ComputeWorldAABB(sRigidBodyState& i_state);
+		bool AABBOverlap(const AABB& i_a, const AABB& i_b);
+		//sweep and prune along the axis of largest spread, the sorted order is kept between frames so the insertion sort is close to linear
+		void SweepAndPrune(std::vector<GameCommon::GameObject *> & i_colliderObjects, std::vector<BroadphasePair>& o_pairs);
+	}
+}
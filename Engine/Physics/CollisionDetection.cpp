@@ -1,5 +1,8 @@
 #include <cmath> 
 #include <vector>
+#include <queue>
+#include <algorithm>
+#include <unordered_map>
 
 #include "CollisionDetection.h"
 #include "Engine/Physics/sRigidBodyState.h"
@@ -7,12 +10,98 @@
 #include "Engine/GameCommon/GameObject.h"
 #include "Engine/Math/cMatrix_transformation.h"
 #include "Engine/Math/Functions.h"
+#include "Broadphase.h"
 
 #define fakeZero -0.000001f
 #define epsilon 1.0e-9f
 
 namespace sca2025 {
 	namespace Physics {
+		namespace {
+			//time of impact of a pair, measured from the start of the frame
+			struct ImpactEvent {
+				float time;
+				int indexA;
+				int indexB;
+				unsigned int versionA;
+				unsigned int versionB;
+				Math::sVector normal4A;
+			};
+			struct LaterImpact {
+				bool operator()(const ImpactEvent& a, const ImpactEvent& b) const
+				{
+					if (a.time != b.time) return a.time > b.time;
+					if (a.indexA != b.indexA) return a.indexA > b.indexA;
+					return a.indexB > b.indexB;
+				}
+			};
+
+			std::priority_queue<ImpactEvent, std::vector<ImpactEvent>, LaterImpact> impactQueue;
+			std::vector<AABB> sweptBoxes;
+			std::vector<unsigned int> bodyVersions;//bumped when the velocity changes, older events are dropped
+			std::unordered_map<sRigidBodyState*, int> bodyIndices;
+			float frameTime = 0.0f;
+			float elapsedTime = 0.0f;
+
+			//ComputeWorldAABB falls back to the hull when no bounding box is set
+			//moving bodies forward does not move their colliders, boxes taken from the collider transformation are shifted to the body
+			AABB ComputeCurrentAABB(sRigidBodyState& i_state)
+			{
+				AABB box = ComputeWorldAABB(i_state);
+				if (i_state.collider.m_type == Sphere || i_state.collider.m_type == TriMesh)
+				{
+					const Math::cMatrix_transformation& m = i_state.collider.m_transformation;
+					box.center += i_state.position - Math::sVector(m.m_03, m.m_13, m.m_23);
+				}
+				return box;
+			}
+
+			//box covering the body from now to the end of the frame
+			AABB ComputeSweptAABB(sRigidBodyState& i_state, float i_timeSpan)
+			{
+				AABB box = ComputeCurrentAABB(i_state);
+				Math::sVector halfMove = i_state.velocity * (0.5f * i_timeSpan);
+				box.center += halfMove;
+				box.extends += Math::sVector(abs(halfMove.x), abs(halfMove.y), abs(halfMove.z));
+				return box;
+			}
+
+			void TestPair(std::vector<GameCommon::GameObject *> & i_allGameObjects, int i, int j)
+			{
+				Math::sVector colNormal4A;
+				float colTime;
+				float remainingTime = frameTime - elapsedTime;
+				bool collisionFound = CollisionDetection(i_allGameObjects[i]->m_State, i_allGameObjects[j]->m_State, remainingTime, colNormal4A, colTime);
+				//only pairs tested here are reported, not every overlapping pair on every search like FindEarliestCollision
+				if (collisionFound && colTime == fakeZero) {
+					i_allGameObjects[i]->OnOverlap(i_allGameObjects[j]);
+					i_allGameObjects[j]->OnOverlap(i_allGameObjects[i]);
+				}
+				if (collisionFound && colTime != fakeZero && colTime < remainingTime) {
+					ImpactEvent impact;
+					impact.time = elapsedTime + colTime;
+					impact.indexA = i;
+					impact.indexB = j;
+					impact.versionA = bodyVersions[i];
+					impact.versionB = bodyVersions[j];
+					impact.normal4A = colNormal4A;
+					impactQueue.push(impact);
+				}
+			}
+
+			//tests the body against every other body whose swept box overlaps its own
+			void TestBody(std::vector<GameCommon::GameObject *> & i_allGameObjects, int i_index, int i_skipIndex)
+			{
+				int count = static_cast<int>(i_allGameObjects.size());
+				for (int j = 0; j < count; j++) {
+					if (j == i_index || j == i_skipIndex) continue;
+					if (!AABBOverlap(sweptBoxes[i_index], sweptBoxes[j])) continue;
+					if (i_index < j) TestPair(i_allGameObjects, i_index, j);
+					else TestPair(i_allGameObjects, j, i_index);
+				}
+			}
+		}
+
 		bool  CollisionDetection(sRigidBodyState  & i_object_A, sRigidBodyState & i_object_B, float i_dt, Math::sVector &o_normal4A, float &o_collisionTime) {
 			
 			Math::cMatrix_transformation A2World_rotation(i_object_A.orientation, Math::sVector(0.0f, 0.0f, 0.0f));
@@ -304,9 +393,13 @@ namespace sca2025 {
 			objectChecked.UpdateOrientation(i_dt);
 			objectChecked.velocity = Math::sVector(0.0f, 0.0f, 0.0f);
 
+			AABB checkedBox = ComputeCurrentAABB(objectChecked);
+
 			size_t numOfObjects = i_allGameObjects.size();
 			for (size_t i = 0; i < numOfObjects; i++) {
 				if (i != indexOfObjectChecked) {
+					//velocities are zeroed, only overlapping boxes can collide
+					if (!AABBOverlap(checkedBox, ComputeCurrentAABB(i_allGameObjects[i]->m_State))) continue;
 					//make a copy 
 					sRigidBodyState otherObject = i_allGameObjects[i]->m_State;
 					otherObject.velocity = Math::sVector(0.0f, 0.0f, 0.0f);
@@ -321,5 +414,69 @@ namespace sca2025 {
 			return false;
 		}
 
+
+		void BeginContinuousCollision(std::vector<GameCommon::GameObject *> & i_allGameObjects, float i_dt) {
+			impactQueue = std::priority_queue<ImpactEvent, std::vector<ImpactEvent>, LaterImpact>();
+			frameTime = i_dt;
+			elapsedTime = 0.0f;
+			int count = static_cast<int>(i_allGameObjects.size());
+			sweptBoxes.resize(count);
+			bodyVersions.assign(count, 0);
+			bodyIndices.clear();
+			std::vector<int> order(count);
+			for (int i = 0; i < count; i++) {
+				sweptBoxes[i] = ComputeSweptAABB(i_allGameObjects[i]->m_State, i_dt);
+				bodyIndices[&i_allGameObjects[i]->m_State] = i;
+				order[i] = i;
+			}
+
+			//sweep and prune along x
+			std::sort(order.begin(), order.end(), [](int a, int b) {
+				return sweptBoxes[a].center.x - sweptBoxes[a].extends.x < sweptBoxes[b].center.x - sweptBoxes[b].extends.x;
+			});
+			for (int i = 0; i < count; i++) {
+				int indexA = order[i];
+				float maxA = sweptBoxes[indexA].center.x + sweptBoxes[indexA].extends.x;
+				for (int j = i + 1; j < count; j++) {
+					int indexB = order[j];
+					if (sweptBoxes[indexB].center.x - sweptBoxes[indexB].extends.x > maxA) break;
+					if (!AABBOverlap(sweptBoxes[indexA], sweptBoxes[indexB])) continue;
+					TestPair(i_allGameObjects, std::min(indexA, indexB), std::max(indexA, indexB));
+				}
+			}
+		}
+
+		bool PopEarliestCollision(std::vector<GameCommon::GameObject *> & i_allGameObjects, CollisionPair & o_earliestCollision) {
+			o_earliestCollision.collisionTime = frameTime - elapsedTime;
+			while (!impactQueue.empty()) {
+				ImpactEvent impact = impactQueue.top();
+				impactQueue.pop();
+				//one of the bodies was hit after this event was computed
+				if (impact.versionA != bodyVersions[impact.indexA] || impact.versionB != bodyVersions[impact.indexB]) continue;
+
+				o_earliestCollision.collisionTime = impact.time - elapsedTime;
+				o_earliestCollision.collisionNormal4A = impact.normal4A;
+				o_earliestCollision.collisionObjects[0] = &i_allGameObjects[impact.indexA]->m_State;
+				o_earliestCollision.collisionObjects[1] = &i_allGameObjects[impact.indexB]->m_State;
+				elapsedTime = impact.time;
+				i_allGameObjects[impact.indexA]->OnHit(i_allGameObjects[impact.indexB]);
+				i_allGameObjects[impact.indexB]->OnHit(i_allGameObjects[impact.indexA]);
+				return true;
+			}
+			return false;
+		}
+
+		void UpdateContinuousCollision(std::vector<GameCommon::GameObject *> & i_allGameObjects, CollisionPair & i_resolvedCollision) {
+			int indexA = bodyIndices[i_resolvedCollision.collisionObjects[0]];
+			int indexB = bodyIndices[i_resolvedCollision.collisionObjects[1]];
+			bodyVersions[indexA]++;
+			bodyVersions[indexB]++;
+			//the other bodies keep their velocity, their boxes from the start of the frame still cover the rest of their path
+			float remainingTime = frameTime - elapsedTime;
+			sweptBoxes[indexA] = ComputeSweptAABB(*i_resolvedCollision.collisionObjects[0], remainingTime);
+			sweptBoxes[indexB] = ComputeSweptAABB(*i_resolvedCollision.collisionObjects[1], remainingTime);
+			TestBody(i_allGameObjects, indexA, -1);
+			TestBody(i_allGameObjects, indexB, indexA);
+		}
 	}
 }
\ No newline at end of file
@@ -14,5 +14,12 @@ namespace sca2025 {
 		bool AxisCheck(sRigidBodyState  & i_object_A, sRigidBodyState & i_object_B, Math::sVector & i_axis, float i_dt, float & o_maxCloseTime, float & o_minOpenTime, Math::sVector &o_normal4A);
 		bool FindEarliestCollision(std::vector<GameCommon::GameObject *> & i_allGameObjects, float i_dt, CollisionPair & o_earliestCollision);
 		bool FindRotationCollision(std::vector<GameCommon::GameObject *> & i_allGameObjects, float i_dt, size_t indexOfObjectChecked);
+
+		//time of impact queue for PhysicsUpdate, only pairs whose swept boxes overlap are tested
+		void BeginContinuousCollision(std::vector<GameCommon::GameObject *> & i_allGameObjects, float i_dt);
+		//same result as FindEarliestCollision, the time is measured from the previous impact
+		bool PopEarliestCollision(std::vector<GameCommon::GameObject *> & i_allGameObjects, CollisionPair & o_earliestCollision);
+		//call after resolving the impact, only pairs of the two bodies are tested again
+		void UpdateContinuousCollision(std::vector<GameCommon::GameObject *> & i_allGameObjects, CollisionPair & i_resolvedCollision);
 	}
 }
\ No newline at end of file
@@ -13,29 +13,23 @@
 sca2025::Physics::SupportResult sca2025::Physics::Collider::getFarthestPointInDirection(Math::sVector i_dir)
 {
 	SupportResult supportResult;
+	//rotate the search direction into local space instead of transforming every vertex
+	Math::sVector localDir(
+		m_transformation.m_00 * i_dir.x + m_transformation.m_10 * i_dir.y + m_transformation.m_20 * i_dir.z,
+		m_transformation.m_01 * i_dir.x + m_transformation.m_11 * i_dir.y + m_transformation.m_21 * i_dir.z,
+		m_transformation.m_02 * i_dir.x + m_transformation.m_12 * i_dir.y + m_transformation.m_22 * i_dir.z);
 	if (m_type == Box)
 	{
-		int selection = 0;
-		float maxDist = Math::Dot(m_transformation * m_vertices[0], i_dir);
-		for (size_t i = 1; i < m_vertices.size(); i++)
-		{
-			float dist = Math::Dot(m_transformation * m_vertices[i], i_dir);//(m_transformation * m_vertices[i]).Dot(i_dir);
-			if (dist > maxDist)
-			{
-				maxDist = dist;
-				selection = (int)i;
-			}
-		}
-		supportResult.globalPosition = m_transformation * m_vertices[selection];
-		supportResult.m_vec3 = m_vertices[selection];//store local position
+		int selection = m_hull->SupportVertex(localDir);
+		supportResult.globalPosition = m_transformation * m_hull->vertices[selection];
+		supportResult.m_vec3 = m_hull->vertices[selection];//store local position
+		supportResult.featureA = selection;
 	}
 	else if (m_type == Sphere)
 	{
-		Math::sVector normalizedSearchDir = i_dir.GetNormalized();
-		float r = m_vertices[1].GetLength();
-		supportResult.globalPosition = m_transformation * m_vertices[0] + r * normalizedSearchDir;
-		Math::cMatrix_transformation world2LocalRot = Math::cMatrix_transformation::CreateWorldToCameraTransform(m_rotMatrix);
-		supportResult.m_vec3 = world2LocalRot * (r * normalizedSearchDir);
+		float r = m_hull->vertices[1].GetLength();
+		supportResult.globalPosition = m_transformation * m_hull->vertices[0] + r * i_dir.GetNormalized();
+		supportResult.m_vec3 = r * localDir.GetNormalized();
 	}
 	return supportResult;
 }
@@ -61,6 +55,8 @@ sca2025::Physics::SupportResult sca2025::Physics::Collider::supportFunction(Coll
 	supportResult.globalPosition = a.globalPosition - b.globalPosition;
 	supportResult.localPositionA = a.m_vec3;
 	supportResult.localPositionB = b.m_vec3;
+	supportResult.featureA = a.featureA;
+	supportResult.featureB = b.featureA;
 	return supportResult;
 }
 
@@ -70,17 +66,31 @@ sca2025::Math::sVector sca2025::Physics::Collider::Center()
 	if (m_type != Sphere)
 	{
 		int count = 0;
-		for (size_t i = 0; i < m_vertices.size(); i++)
+		for (size_t i = 0; i < m_hull->vertices.size(); i++)
 		{
-			center = center + m_transformation * m_vertices[i];
+			center = center + m_transformation * m_hull->vertices[i];
 			count++;
 		}
 		return center / float(count);
 	}
-	center = m_transformation * m_vertices[0];
+	center = m_transformation * m_hull->vertices[0];
 	return center;
 }
 
+namespace
+{
+	//contact feature is the support vertex pair with the largest barycentric weight on the closest EPA face
+	unsigned int GetFeatureId(sca2025::Physics::SupportResult* i_face, float u, float v, float w)
+	{
+		int dominant = 0;
+		if (v > u && v >= w) dominant = 1;
+		else if (w > u && w > v) dominant = 2;
+		const sca2025::Physics::SupportResult& vertex = i_face[dominant];
+		if (vertex.featureA < 0 && vertex.featureB < 0) return 0;
+		return (static_cast<unsigned int>(vertex.featureA + 1) << 16) | static_cast<unsigned int>(vertex.featureB + 1);
+	}
+}
+
 sca2025::Physics::Contact sca2025::Physics::Collider::getContact(Simplex&i_simplex, Collider* coll2)
 {
 	Contact contact;//output
@@ -149,6 +159,7 @@ sca2025::Physics::Contact sca2025::Physics::Collider::getContact(Simplex&i_simpl
 			contact.tangent2 = Math::Cross(contact.normal, contact.tangent1).GetNormalized();
 			contact.colliderA = this;
 			contact.colliderB = coll2;
+			contact.featureId = GetFeatureId(faces[closest_face], u, v, w);
 			return contact;
 		}
 
@@ -237,24 +248,37 @@ sca2025::Physics::Contact sca2025::Physics::Collider::getContact(Simplex&i_simpl
 	contact.tangent2 = Math::Cross(contact.normal, contact.tangent1).GetNormalized();
 	contact.colliderA = this;
 	contact.colliderB = coll2;
+	contact.featureId = GetFeatureId(faces[closest_face], u, v, w);
 	return contact;
 }
 
 bool sca2025::Physics::Collider::IsCollided(Collider&i_B, Contact& o_contact)
 {
-	Math::sVector dir = i_B.Center() - this->Center();
+	Math::sVector dir;
+	return IsCollided(i_B, o_contact, dir);
+}
+
+bool sca2025::Physics::Collider::IsCollided(Collider&i_B, Contact& o_contact, Math::sVector& io_searchDir)
+{
+	Math::sVector dir = io_searchDir;
+	if (dir.GetLengthSQ() < 0.000000000001f)
+	{
+		dir = i_B.Center() - this->Center();
+	}
 	Simplex simplex;
-	simplex.Clear();
 	while (true)
 	{
 		simplex.Add(supportFunction(*this, i_B, dir));
 
 		if (Math::Dot(simplex.GetLast().globalPosition, dir) < 0) {
+			//dir separates the pair, reuse it next frame
+			io_searchDir = dir;
 			return false;
 		}
 		else {
 			if (simplex.ContainsOrigin(dir)) {
 				o_contact = getContact(simplex, &i_B);
+				io_searchDir = o_contact.normal;
 				return true;
 			}
 		}
@@ -367,40 +391,35 @@ bool sca2025::Physics::Simplex::ContainsOrigin(Math::sVector &t_direction)
 	return false;
 }
 
-sca2025::Physics::Collider::Collider() { m_vertices.clear(); }
+sca2025::Physics::Collider::Collider()
+{
+	//every default collider shares one empty hull
+	static const std::shared_ptr<const ConvexHull> emptyHull = std::make_shared<const ConvexHull>();
+	m_hull = emptyHull;
+}
 
 sca2025::Physics::Collider::Collider(std::vector<Math::sVector>& i_v, ColliderType i_type)
 {
-	m_vertices = i_v;
+	m_hull = AcquireConvexHull(i_v, std::vector<std::vector<int>>());
 	m_type = i_type;
 }
 
 sca2025::Physics::Collider::Collider(const Collider& i_v)
 {
-	m_vertices = i_v.m_vertices;
+	m_hull = i_v.m_hull;
+	m_mesh = i_v.m_mesh;
 	m_type = i_v.m_type;
 }
 
 void sca2025::Physics::Collider::InitializeCollider(AABB &i_box)
 {
-	m_vertices.resize(8);
-	for (int i = 0; i < 8; i++)
-	{
-		m_vertices[i] = i_box.extends;
-	}
-	m_vertices[1].z = -m_vertices[1].z;
-	m_vertices[2] = m_vertices[1];
-	m_vertices[2].x = -m_vertices[2].x;
-	m_vertices[3] = m_vertices[2];
-	m_vertices[3].z = -m_vertices[3].z;
-
-	m_vertices[4].y = -m_vertices[4].y;
-	m_vertices[5] = m_vertices[4];
-	m_vertices[5].z = -m_vertices[5].z;
-	m_vertices[6] = m_vertices[5];
-	m_vertices[6].x = -m_vertices[6].x;
-	m_vertices[7] = m_vertices[6];
-	m_vertices[7].z = -m_vertices[7].z;
+	m_hull = AcquireBoxHull(i_box.extends);
+}
+
+void sca2025::Physics::Collider::InitializeCollider(const std::shared_ptr<const TriangleMesh>& i_mesh)
+{
+	m_mesh = i_mesh;
+	m_type = TriMesh;
 }
 
 void sca2025::Physics::Collider::UpdateTransformation(sca2025::Math::cMatrix_transformation i_t, sca2025::Math::cMatrix_transformation i_rot)
@@ -410,6 +429,21 @@ void sca2025::Physics::Collider::UpdateTransformation(sca2025::Math::cMatrix_tra
 
 }
 
+namespace
+{
+	//carry the accumulated impulses of a matched contact over, friction is reprojected onto the new tangent basis
+	void CarryImpulses(const sca2025::Physics::Contact& i_cached, sca2025::Physics::Contact& o_contact)
+	{
+		sca2025::Math::sVector frictionImpulse = i_cached.tangent1 * i_cached.oldTangent1Lambda + i_cached.tangent2 * i_cached.oldTangent2Lambda;
+		o_contact.oldNormalLambda = i_cached.oldNormalLambda;
+		o_contact.oldTangent1Lambda = sca2025::Math::Dot(frictionImpulse, o_contact.tangent1);
+		o_contact.oldTangent2Lambda = sca2025::Math::Dot(frictionImpulse, o_contact.tangent2);
+		o_contact.lambdaCached = i_cached.lambdaCached;
+		o_contact.enableWarmStart = true;
+		o_contact.persistent = true;
+	}
+}
+
 void sca2025::Physics::MergeContact(Contact& i_contact, ContactManifold3D& o_dest)
 {
 	float persistentThresholdSQ = 0.0025f;
@@ -435,6 +469,7 @@ void sca2025::Physics::MergeContact(Contact& i_contact, ContactManifold3D& o_des
 			{
 				// contact persistent, keep
 				contact.persistent = true;
+				contact.enableWarmStart = true;
 				//update penetration depth
 				contact.depth = Math::Dot(localToGlobalA - localToGlobalB, contact.normal);
 			}
@@ -448,17 +483,41 @@ void sca2025::Physics::MergeContact(Contact& i_contact, ContactManifold3D& o_des
 	} // end of check persistent contacts
 
 	// process new contacts
-	// discard new contact if it's too close to cached contacts
-	bool discard = false;
+	// a new contact with the same feature as a cached one refreshes it and keeps its impulses for warm starting,
+	// a featureless contact is matched by distance, anything else starts cold
+	int match = -1;
+	bool warm = false;
 	for (int i = 0; i < o_dest.numContacts; i++)
 	{
-		if ((i_contact.globalPositionA - o_dest.m_contacts[i].globalPositionA).GetLengthSQ() < persistentThresholdSQ)
+		if (i_contact.featureId != 0 && o_dest.m_contacts[i].featureId == i_contact.featureId)
 		{
-			discard = true;
+			match = i;
+			warm = true;
 			break;
 		}
 	}
-	if (!discard)
+	if (match < 0)
+	{
+		for (int i = 0; i < o_dest.numContacts; i++)
+		{
+			if ((i_contact.globalPositionA - o_dest.m_contacts[i].globalPositionA).GetLengthSQ() < persistentThresholdSQ)
+			{
+				match = i;
+				warm = i_contact.featureId == 0 || o_dest.m_contacts[i].featureId == 0;
+				break;
+			}
+		}
+	}
+	if (match >= 0)
+	{
+		Contact cached = o_dest.m_contacts[match];
+		o_dest.m_contacts[match] = i_contact;
+		if (warm)
+		{
+			CarryImpulses(cached, o_dest.m_contacts[match]);
+		}
+	}
+	else
 	{
 		// add new contact to valid list
 		o_dest.AddContact(i_contact);
@@ -541,4 +600,28 @@ void sca2025::Physics::MergeContact(Contact& i_contact, ContactManifold3D& o_des
 		o_dest.AddContact(furthest2);
 		o_dest.AddContact(furthest3);
 	}
+}
+
+void sca2025::Physics::ReplaceManifold(Contact* i_contacts, int i_count, ContactManifold3D& o_dest)
+{
+	float persistentThresholdSQ = 0.0025f;
+	for (int i = 0; i < i_count; i++)
+	{
+		for (int j = 0; j < o_dest.numContacts; j++)
+		{
+			const Contact& cached = o_dest.m_contacts[j];
+			bool matched = i_contacts[i].featureId != 0 ? cached.featureId == i_contacts[i].featureId
+				: (i_contacts[i].globalPositionA - cached.globalPositionA).GetLengthSQ() < persistentThresholdSQ;
+			if (matched)
+			{
+				CarryImpulses(cached, i_contacts[i]);
+				break;
+			}
+		}
+	}
+	o_dest.Clear();
+	for (int i = 0; i < i_count && i < 4; i++)
+	{
+		o_dest.AddContact(i_contacts[i]);
+	}
 }
\ No newline at end of file
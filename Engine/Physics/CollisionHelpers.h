@@ -5,12 +5,14 @@
 #include <Engine/Math/cMatrix_transformation.h>
 #include <Engine/Math/sVector.h>
 #include "External/EigenLibrary/Eigen/Dense"
+#include "ConvexHull.h"
+#include "TriangleMesh.h"
 
 using namespace Eigen;
 
 namespace sca2025
 {
-	enum ColliderType { Box, Sphere };
+	enum ColliderType { Box, Sphere, Plane, TriMesh };//a plane collider hull stores a point in vertices[0] and its outward normal in vertices[1], TriMesh colliders are static
 	namespace Physics
 	{
 		class Collider;//forward declaration
@@ -35,16 +37,19 @@ namespace sca2025
 			float tangentImpulseSum1 = 0.0f;
 			float tangentImpulseSum2 = 0.0f;
 
-			//warm start
+			//warm start, accumulated impulses of the previous step
 			float oldNormalLambda = 0.0f;
 			float oldTangent1Lambda = 0.0f;
 			float oldTangent2Lambda = 0.0f;
 
+			//vertex pair that generated the contact, 0 means no feature (curved surface) and the contact is matched by distance
+			unsigned int featureId = 0;
+
 			Collider* colliderA;
 			Collider* colliderB;
 			bool persistent = false;
 			bool lambdaCached = false;
-			bool enableWarmStart = false;
+			bool enableWarmStart = false;//set when the contact is matched to a cached one
 		};
 
 		class ContactManifold3D
@@ -67,6 +72,8 @@ namespace sca2025
 			}
 			Contact m_contacts[5];//maxmum is 4, 5th one is used to select the best 4
 			int numContacts = 0;
+			Collider* colliderA = nullptr;
+			Collider* colliderB = nullptr;
 		};
 
 		//struct to cache local position of support function result
@@ -76,44 +83,59 @@ namespace sca2025
 			Math::sVector localPositionA;
 			Math::sVector localPositionB;
 			Math::sVector m_vec3;//SupportResult serves the purpose of m_vec3 wrapper
+			int featureA = -1;//vertex index of the support point, -1 for spheres
+			int featureB = -1;
 		};
 
+		//fixed capacity simplex, GJK never holds more than 4 points
 		class Simplex
 		{
 		public:
-			std::vector<SupportResult> m_points;
+			SupportResult m_points[4];
+			int m_size = 0;
 
-			Simplex() { m_points.clear(); }
-			size_t GetSize() { return m_points.size(); }
-			void Clear() { m_points.clear(); }
+			Simplex() { m_size = 0; }
+			size_t GetSize() { return static_cast<size_t>(m_size); }
+			void Clear() { m_size = 0; }
 			SupportResult GetA() { return m_points[0]; }
 			SupportResult GetB() { return m_points[1]; }
 			SupportResult GetC() { return m_points[2]; }
 			SupportResult GetD() { return m_points[3]; }
-			void RemoveA() { m_points.erase(m_points.begin()); }
-			void RemoveB() { m_points.erase(m_points.begin() + 1); }
-			void RemoveC() { m_points.erase(m_points.begin() + 2); }
-			void RemoveD() { m_points.erase(m_points.begin() + 3); }
-			void Add(SupportResult i_data) { m_points.push_back(i_data); }
-			SupportResult GetLast() { return m_points[m_points.size() - 1]; }
+			void RemoveA() { RemoveAt(0); }
+			void RemoveB() { RemoveAt(1); }
+			void RemoveC() { RemoveAt(2); }
+			void RemoveD() { RemoveAt(3); }
+			void Add(SupportResult i_data) { if (m_size < 4) m_points[m_size++] = i_data; }
+			SupportResult GetLast() { return m_points[m_size - 1]; }
 			bool ContainsOrigin(Math::sVector& i_d);
+		private:
+			void RemoveAt(int i_index)
+			{
+				for (int i = i_index; i < m_size - 1; i++) m_points[i] = m_points[i + 1];
+				m_size--;
+			}
 		};
 
 		class Collider
 		{
 		public:
 			Collider();
+			//the vertices are looked up in the hull cache, colliders of the same shape share one hull
 			Collider(std::vector<Math::sVector>& i_v, ColliderType i_type);
 			Collider(const Collider& i_v);
 
 			void InitializeCollider(AABB &i_box);
+			void InitializeCollider(const std::shared_ptr<const TriangleMesh>& i_mesh);
 			void UpdateTransformation(sca2025::Math::cMatrix_transformation i_t, sca2025::Math::cMatrix_transformation i_rot);
 			Math::sVector Center();
 			bool IsCollided(Collider& i_B, Contact& o_contact);
+			//io_searchDir seeds GJK (zero means start from the centers) and returns the last search direction for the next frame
+			bool IsCollided(Collider& i_B, Contact& o_contact, Math::sVector& io_searchDir);
 			void RemoveManifold(ContactManifold3D* i_pManifold);
 
 			sca2025::Math::cMatrix_transformation m_transformation;
-			std::vector<Math::sVector> m_vertices;
+			std::shared_ptr<const ConvexHull> m_hull;//never null, copying a collider only copies the reference
+			std::shared_ptr<const TriangleMesh> m_mesh;//TriMesh colliders only
 			std::vector<ContactManifold3D*> m_pManifolds;
 			sRigidBodyState* m_pParentRigidBody;
 			ColliderType m_type;
@@ -125,5 +147,7 @@ namespace sca2025
 		};
 
 		void MergeContact(Contact& i_contact, ContactManifold3D& o_dest);
+		//replaces the manifold with a complete set of contacts, impulses of matched contacts are kept for warm starting
+		void ReplaceManifold(Contact* i_contacts, int i_count, ContactManifold3D& o_dest);
 	}
 }
\ No newline at end of file
@@ -1,7 +1,9 @@
 #include <algorithm> 
+#include <cmath>
 #include "sRigidBodyState.h"
 #include <vector>
 #include "Engine/Physics/PhysicsSimulation.h"
+#include "CollisionResolver.h"
 #include "External/EigenLibrary/Eigen/Dense"
 
 using namespace Eigen;
@@ -9,165 +11,183 @@ namespace sca2025
 {
 	namespace Physics
 	{
-		void CollisionResolver(float i_dt, int k)
+		void CollisionResolver(float i_dt, int k, SolverResidual& io_residual)
 		{
-			
 			for (size_t i = 0; i < allManifolds.size(); i++)
 			{
-				for (int j = 0; j < allManifolds[i].numContacts; j++)
+				ResolveManifold(allManifolds[i], i_dt, k, false, io_residual);
+			}
+		}
+
+		void WarmStartContact(Contact& io_contact)
+		{
+			sRigidBodyState* rigidBodyA = io_contact.colliderA->m_pParentRigidBody;
+			sRigidBodyState* rigidBodyB = io_contact.colliderB->m_pParentRigidBody;
+			if (io_contact.lambdaCached && io_contact.enableWarmStart)
+			{
+				//warm start matched contacts with last step's accumulated impulses
+				Math::sVector rA = io_contact.globalPositionA - rigidBodyA->position;
+				Math::sVector rB = io_contact.globalPositionB - rigidBodyB->position;
+				io_contact.normalImpulseSum = io_contact.oldNormalLambda;
+				io_contact.tangentImpulseSum1 = io_contact.oldTangent1Lambda;
+				io_contact.tangentImpulseSum2 = io_contact.oldTangent2Lambda;
+				Math::sVector impulse = io_contact.normal * io_contact.normalImpulseSum + io_contact.tangent1 * io_contact.tangentImpulseSum1 + io_contact.tangent2 * io_contact.tangentImpulseSum2;
+				if (!rigidBodyA->isStatic)
+				{
+					rigidBodyA->velocity = rigidBodyA->velocity - impulse * (1 / rigidBodyA->mass);
+					rigidBodyA->angularVelocity = rigidBodyA->angularVelocity - rigidBodyA->globalInverseInertiaTensor * Math::Cross(rA, impulse);
+				}
+				if (!rigidBodyB->isStatic)
 				{
-					sRigidBodyState* rigidBodyA = allManifolds[i].m_contacts[j].colliderA->m_pParentRigidBody;
-					sRigidBodyState* rigidBodyB = allManifolds[i].m_contacts[j].colliderB->m_pParentRigidBody;
-					Math::sVector rA = allManifolds[i].m_contacts[j].globalPositionA - rigidBodyA->position;
-					Math::sVector rB = allManifolds[i].m_contacts[j].globalPositionB - rigidBodyB->position;
+					rigidBodyB->velocity = rigidBodyB->velocity + impulse * (1 / rigidBodyB->mass);
+					rigidBodyB->angularVelocity = rigidBodyB->angularVelocity + rigidBodyB->globalInverseInertiaTensor * Math::Cross(rB, impulse);
+				}
+			}
+			else
+			{
+				io_contact.normalImpulseSum = 0;
+				io_contact.tangentImpulseSum1 = 0;
+				io_contact.tangentImpulseSum2 = 0;
+			}
+		}
 
-					if (k == 0)
+		void ResolveManifold(ContactManifold3D& io_manifold, float i_dt, int k, bool i_relax, SolverResidual& io_residual)
+		{
+			for (int j = 0; j < io_manifold.numContacts; j++)
+			{
+				sRigidBodyState* rigidBodyA = io_manifold.m_contacts[j].colliderA->m_pParentRigidBody;
+				sRigidBodyState* rigidBodyB = io_manifold.m_contacts[j].colliderB->m_pParentRigidBody;
+				Math::sVector rA = io_manifold.m_contacts[j].globalPositionA - rigidBodyA->position;
+				Math::sVector rB = io_manifold.m_contacts[j].globalPositionB - rigidBodyB->position;
+
+				if (k == 0 && !i_relax)
+				{
+					WarmStartContact(io_manifold.m_contacts[j]);
+				}
+				//normal
+				{	
+					float JV;
+					JV = Math::Dot(rigidBodyB->velocity + Math::Cross(rigidBodyB->angularVelocity, rB) - rigidBodyA->velocity - Math::Cross(rigidBodyA->angularVelocity, rA), io_manifold.m_contacts[j].normal);
+
+					float effectiveMass;
+					Math::sVector neRAxN = Math::Cross(-rA, io_manifold.m_contacts[j].normal);
+					Math::sVector poRBxN = Math::Cross(rB, io_manifold.m_contacts[j].normal);
+
+					effectiveMass = Math::Dot(-io_manifold.m_contacts[j].normal, -io_manifold.m_contacts[j].normal*(1 / rigidBodyA->mass))
+						+ Math::Dot(neRAxN, rigidBodyA->globalInverseInertiaTensor * neRAxN)
+						+ Math::Dot(io_manifold.m_contacts[j].normal, io_manifold.m_contacts[j].normal*(1 / rigidBodyB->mass))
+						+ Math::Dot(poRBxN, rigidBodyB->globalInverseInertiaTensor * poRBxN);
+
+					float beta = 0.1f;
+					float CR = 0.7f;//0.7f
+					float SlopP = 0.001f;
+					float SlopR = 0.5f;
+					float b = -beta / i_dt * std::max(io_manifold.m_contacts[j].depth - SlopP, 0.0f) - CR * std::max(-JV - SlopR, 0.0f);
+					if (i_relax) b = 0.0f;
+					
+					float lambda;
+					lambda = (-JV - b) / effectiveMass;
+
+					float oldImpulseSum = io_manifold.m_contacts[j].normalImpulseSum;
+					io_manifold.m_contacts[j].normalImpulseSum = io_manifold.m_contacts[j].normalImpulseSum + lambda;
+					if (io_manifold.m_contacts[j].normalImpulseSum < 0) io_manifold.m_contacts[j].normalImpulseSum = 0;
+					lambda = io_manifold.m_contacts[j].normalImpulseSum - oldImpulseSum;
+						
+					io_residual.Add(std::abs(lambda), std::abs(lambda) * effectiveMass);
+					//cached every sweep since the island may stop iterating early
+					io_manifold.m_contacts[j].oldNormalLambda = io_manifold.m_contacts[j].normalImpulseSum;
+					io_manifold.m_contacts[j].lambdaCached = true;
+					
+					if (!rigidBodyA->isStatic)
 					{
-						allManifolds[i].m_contacts[j].normalImpulseSum = 0;
-						allManifolds[i].m_contacts[j].tangentImpulseSum1 = 0;
-						allManifolds[i].m_contacts[j].tangentImpulseSum2 = 0;
+						rigidBodyA->velocity = rigidBodyA->velocity + lambda * -io_manifold.m_contacts[j].normal*(1 / rigidBodyA->mass);
+						rigidBodyA->angularVelocity = rigidBodyA->angularVelocity + rigidBodyA->globalInverseInertiaTensor * neRAxN * lambda;
 					}
-					//normal
-					{	
-						float JV;
-						JV = Math::Dot(rigidBodyB->velocity + Math::Cross(rigidBodyB->angularVelocity, rB) - rigidBodyA->velocity - Math::Cross(rigidBodyA->angularVelocity, rA), allManifolds[i].m_contacts[j].normal);
-
-						float effectiveMass;
-						Math::sVector neRAxN = Math::Cross(-rA, allManifolds[i].m_contacts[j].normal);
-						Math::sVector poRBxN = Math::Cross(rB, allManifolds[i].m_contacts[j].normal);
-
-						effectiveMass = Math::Dot(-allManifolds[i].m_contacts[j].normal, -allManifolds[i].m_contacts[j].normal*(1 / rigidBodyA->mass))
-							+ Math::Dot(neRAxN, rigidBodyA->globalInverseInertiaTensor * neRAxN)
-							+ Math::Dot(allManifolds[i].m_contacts[j].normal, allManifolds[i].m_contacts[j].normal*(1 / rigidBodyB->mass))
-							+ Math::Dot(poRBxN, rigidBodyB->globalInverseInertiaTensor * poRBxN);
-
-						float beta = 0.1f;
-						float CR = 0.7f;//0.7f
-						float SlopP = 0.001f;
-						float SlopR = 0.5f;
-						float b = -beta / i_dt * std::max(allManifolds[i].m_contacts[j].depth - SlopP, 0.0f) - CR * std::max(-JV - SlopR, 0.0f);
-						
-						float lambda;
-						lambda = (-JV - b) / effectiveMass;
-
-						float oldImpulseSum = allManifolds[i].m_contacts[j].normalImpulseSum;
-						allManifolds[i].m_contacts[j].normalImpulseSum = allManifolds[i].m_contacts[j].normalImpulseSum + lambda;
-						if (allManifolds[i].m_contacts[j].normalImpulseSum < 0) allManifolds[i].m_contacts[j].normalImpulseSum = 0;
-						lambda = allManifolds[i].m_contacts[j].normalImpulseSum - oldImpulseSum;
-							
-						if (allManifolds[i].m_contacts[j].lambdaCached && k == 0 && allManifolds[i].m_contacts[j].enableWarmStart)
-						{
-							lambda = 0.8f * allManifolds[i].m_contacts[j].oldNormalLambda + 0.2f * lambda;
-						}
-						if (k == constraintMaxNum - 1)
-						{
-							allManifolds[i].m_contacts[j].oldNormalLambda = lambda;
-							allManifolds[i].m_contacts[j].lambdaCached = true;
-						}
-						
-						if (!rigidBodyA->isStatic)
-						{
-							rigidBodyA->velocity = rigidBodyA->velocity + lambda * -allManifolds[i].m_contacts[j].normal*(1 / rigidBodyA->mass);
-							rigidBodyA->angularVelocity = rigidBodyA->angularVelocity + rigidBodyA->globalInverseInertiaTensor * neRAxN * lambda;
-						}
-						if (!rigidBodyB->isStatic)
-						{
-							rigidBodyB->velocity = rigidBodyB->velocity + lambda * allManifolds[i].m_contacts[j].normal*(1 / rigidBodyB->mass);
-							rigidBodyB->angularVelocity = rigidBodyB->angularVelocity + rigidBodyB->globalInverseInertiaTensor * poRBxN * lambda;
-						}	
+					if (!rigidBodyB->isStatic)
+					{
+						rigidBodyB->velocity = rigidBodyB->velocity + lambda * io_manifold.m_contacts[j].normal*(1 / rigidBodyB->mass);
+						rigidBodyB->angularVelocity = rigidBodyB->angularVelocity + rigidBodyB->globalInverseInertiaTensor * poRBxN * lambda;
+					}	
+				}
+					
+				//fricition 1
+				{
+					float JV;
+					JV = Math::Dot(rigidBodyB->velocity + Math::Cross(rigidBodyB->angularVelocity, rB) - rigidBodyA->velocity - Math::Cross(rigidBodyA->angularVelocity, rA), io_manifold.m_contacts[j].tangent1);
+
+					float effectiveMass;
+					Math::sVector neRAxN = Math::Cross(-rA, io_manifold.m_contacts[j].tangent1);
+					Math::sVector poRBxN = Math::Cross(rB, io_manifold.m_contacts[j].tangent1);
+
+					effectiveMass = Math::Dot(-io_manifold.m_contacts[j].tangent1, -io_manifold.m_contacts[j].tangent1*(1 / rigidBodyA->mass))
+						+ Math::Dot(neRAxN, rigidBodyA->globalInverseInertiaTensor * neRAxN)
+						+ Math::Dot(io_manifold.m_contacts[j].tangent1, io_manifold.m_contacts[j].tangent1*(1 / rigidBodyB->mass))
+						+ Math::Dot(poRBxN, rigidBodyB->globalInverseInertiaTensor * poRBxN);
+
+					float lambda;
+					lambda = -JV / effectiveMass;
+
+					float CF = 50.0f;
+					float oldImpulseT = io_manifold.m_contacts[j].tangentImpulseSum1;
+					io_manifold.m_contacts[j].tangentImpulseSum1 = io_manifold.m_contacts[j].tangentImpulseSum1 + lambda;
+					if (io_manifold.m_contacts[j].tangentImpulseSum1 < -io_manifold.m_contacts[j].normalImpulseSum * CF) io_manifold.m_contacts[j].tangentImpulseSum1 = -io_manifold.m_contacts[j].normalImpulseSum * CF;
+					else if (io_manifold.m_contacts[j].tangentImpulseSum1 > io_manifold.m_contacts[j].normalImpulseSum * CF) io_manifold.m_contacts[j].tangentImpulseSum1 = io_manifold.m_contacts[j].normalImpulseSum * CF;
+					lambda = io_manifold.m_contacts[j].tangentImpulseSum1 - oldImpulseT;
+
+					io_residual.Add(std::abs(lambda), std::abs(lambda) * effectiveMass);
+					io_manifold.m_contacts[j].oldTangent1Lambda = io_manifold.m_contacts[j].tangentImpulseSum1;
+
+					if (!rigidBodyA->isStatic)
+					{
+						rigidBodyA->velocity = rigidBodyA->velocity + lambda * -io_manifold.m_contacts[j].tangent1*(1 / rigidBodyA->mass);
+						rigidBodyA->angularVelocity = rigidBodyA->angularVelocity + rigidBodyA->globalInverseInertiaTensor * neRAxN * lambda;
 					}
-						
-					//fricition 1
+					if (!rigidBodyB->isStatic)
 					{
-						float JV;
-						JV = Math::Dot(rigidBodyB->velocity + Math::Cross(rigidBodyB->angularVelocity, rB) - rigidBodyA->velocity - Math::Cross(rigidBodyA->angularVelocity, rA), allManifolds[i].m_contacts[j].tangent1);
-
-						float effectiveMass;
-						Math::sVector neRAxN = Math::Cross(-rA, allManifolds[i].m_contacts[j].tangent1);
-						Math::sVector poRBxN = Math::Cross(rB, allManifolds[i].m_contacts[j].tangent1);
-
-						effectiveMass = Math::Dot(-allManifolds[i].m_contacts[j].tangent1, -allManifolds[i].m_contacts[j].tangent1*(1 / rigidBodyA->mass))
-							+ Math::Dot(neRAxN, rigidBodyA->globalInverseInertiaTensor * neRAxN)
-							+ Math::Dot(allManifolds[i].m_contacts[j].tangent1, allManifolds[i].m_contacts[j].tangent1*(1 / rigidBodyB->mass))
-							+ Math::Dot(poRBxN, rigidBodyB->globalInverseInertiaTensor * poRBxN);
-
-						float lambda;
-						lambda = -JV / effectiveMass;
-
-						float CF = 50.0f;
-						float oldImpulseT = allManifolds[i].m_contacts[j].tangentImpulseSum1;
-						allManifolds[i].m_contacts[j].tangentImpulseSum1 = allManifolds[i].m_contacts[j].tangentImpulseSum1 + lambda;
-						if (allManifolds[i].m_contacts[j].tangentImpulseSum1 < -allManifolds[i].m_contacts[j].normalImpulseSum * CF) allManifolds[i].m_contacts[j].tangentImpulseSum1 = -allManifolds[i].m_contacts[j].normalImpulseSum * CF;
-						else if (allManifolds[i].m_contacts[j].tangentImpulseSum1 > allManifolds[i].m_contacts[j].normalImpulseSum * CF) allManifolds[i].m_contacts[j].tangentImpulseSum1 = allManifolds[i].m_contacts[j].normalImpulseSum * CF;
-						lambda = allManifolds[i].m_contacts[j].tangentImpulseSum1 - oldImpulseT;
-
-						if (allManifolds[i].m_contacts[j].lambdaCached && k == 0 && allManifolds[i].m_contacts[j].enableWarmStart)
-						{
-							lambda = 0.8f * allManifolds[i].m_contacts[j].oldTangent1Lambda + 0.2f * lambda;
-						}
-						if (k == constraintMaxNum - 1)
-						{
-							allManifolds[i].m_contacts[j].oldTangent1Lambda = lambda;
-						}
-
-						if (!rigidBodyA->isStatic)
-						{
-							rigidBodyA->velocity = rigidBodyA->velocity + lambda * -allManifolds[i].m_contacts[j].tangent1*(1 / rigidBodyA->mass);
-							rigidBodyA->angularVelocity = rigidBodyA->angularVelocity + rigidBodyA->globalInverseInertiaTensor * neRAxN * lambda;
-						}
-						if (!rigidBodyB->isStatic)
-						{
-							rigidBodyB->velocity = rigidBodyB->velocity + lambda * allManifolds[i].m_contacts[j].tangent1*(1 / rigidBodyB->mass);
-							rigidBodyB->angularVelocity = rigidBodyB->angularVelocity + rigidBodyB->globalInverseInertiaTensor * poRBxN * lambda;
-						}
+						rigidBodyB->velocity = rigidBodyB->velocity + lambda * io_manifold.m_contacts[j].tangent1*(1 / rigidBodyB->mass);
+						rigidBodyB->angularVelocity = rigidBodyB->angularVelocity + rigidBodyB->globalInverseInertiaTensor * poRBxN * lambda;
 					}
+				}
 
-					//friction 2
+				//friction 2
+				{
+					float JV;
+					JV = Math::Dot(rigidBodyB->velocity + Math::Cross(rigidBodyB->angularVelocity, rB) - rigidBodyA->velocity - Math::Cross(rigidBodyA->angularVelocity, rA), io_manifold.m_contacts[j].tangent2);
+
+					float effectiveMass;
+					Math::sVector neRAxN = Math::Cross(-rA, io_manifold.m_contacts[j].tangent2);
+					Math::sVector poRBxN = Math::Cross(rB, io_manifold.m_contacts[j].tangent2);
+
+					effectiveMass = Math::Dot(-io_manifold.m_contacts[j].tangent2, -io_manifold.m_contacts[j].tangent2*(1 / rigidBodyA->mass))
+						+ Math::Dot(neRAxN, rigidBodyA->globalInverseInertiaTensor * neRAxN)
+						+ Math::Dot(io_manifold.m_contacts[j].tangent2, io_manifold.m_contacts[j].tangent2*(1 / rigidBodyB->mass))
+						+ Math::Dot(poRBxN, rigidBodyB->globalInverseInertiaTensor * poRBxN);
+
+					float lambda;
+					lambda = -JV / effectiveMass;
+
+					float CF = 50.0f;
+					float oldImpulseT = io_manifold.m_contacts[j].tangentImpulseSum2;
+					io_manifold.m_contacts[j].tangentImpulseSum2 = io_manifold.m_contacts[j].tangentImpulseSum2 + lambda;
+					if (io_manifold.m_contacts[j].tangentImpulseSum2 < -io_manifold.m_contacts[j].normalImpulseSum * CF) io_manifold.m_contacts[j].tangentImpulseSum2 = -io_manifold.m_contacts[j].normalImpulseSum * CF;
+					else if (io_manifold.m_contacts[j].tangentImpulseSum2 > io_manifold.m_contacts[j].normalImpulseSum * CF) io_manifold.m_contacts[j].tangentImpulseSum2 = io_manifold.m_contacts[j].normalImpulseSum * CF;
+					lambda = io_manifold.m_contacts[j].tangentImpulseSum2 - oldImpulseT;
+
+					io_residual.Add(std::abs(lambda), std::abs(lambda) * effectiveMass);
+					io_manifold.m_contacts[j].oldTangent2Lambda = io_manifold.m_contacts[j].tangentImpulseSum2;
+
+					if (!rigidBodyA->isStatic)
+					{
+						rigidBodyA->velocity = rigidBodyA->velocity + lambda * -io_manifold.m_contacts[j].tangent2*(1 / rigidBodyA->mass);
+						rigidBodyA->angularVelocity = rigidBodyA->angularVelocity + rigidBodyA->globalInverseInertiaTensor * neRAxN * lambda;
+					}
+					if (!rigidBodyB->isStatic)
 					{
-						float JV;
-						JV = Math::Dot(rigidBodyB->velocity + Math::Cross(rigidBodyB->angularVelocity, rB) - rigidBodyA->velocity - Math::Cross(rigidBodyA->angularVelocity, rA), allManifolds[i].m_contacts[j].tangent2);
-
-						float effectiveMass;
-						Math::sVector neRAxN = Math::Cross(-rA, allManifolds[i].m_contacts[j].tangent2);
-						Math::sVector poRBxN = Math::Cross(rB, allManifolds[i].m_contacts[j].tangent2);
-
-						effectiveMass = Math::Dot(-allManifolds[i].m_contacts[j].tangent2, -allManifolds[i].m_contacts[j].tangent2*(1 / rigidBodyA->mass))
-							+ Math::Dot(neRAxN, rigidBodyA->globalInverseInertiaTensor * neRAxN)
-							+ Math::Dot(allManifolds[i].m_contacts[j].tangent2, allManifolds[i].m_contacts[j].tangent2*(1 / rigidBodyB->mass))
-							+ Math::Dot(poRBxN, rigidBodyB->globalInverseInertiaTensor * poRBxN);
-
-						float lambda;
-						lambda = -JV / effectiveMass;
-
-						float CF = 50.0f;
-						float oldImpulseT = allManifolds[i].m_contacts[j].tangentImpulseSum2;
-						allManifolds[i].m_contacts[j].tangentImpulseSum2 = allManifolds[i].m_contacts[j].tangentImpulseSum2 + lambda;
-						if (allManifolds[i].m_contacts[j].tangentImpulseSum2 < -allManifolds[i].m_contacts[j].normalImpulseSum * CF) allManifolds[i].m_contacts[j].tangentImpulseSum2 = -allManifolds[i].m_contacts[j].normalImpulseSum * CF;
-						else if (allManifolds[i].m_contacts[j].tangentImpulseSum2 > allManifolds[i].m_contacts[j].normalImpulseSum * CF) allManifolds[i].m_contacts[j].tangentImpulseSum2 = allManifolds[i].m_contacts[j].normalImpulseSum * CF;
-						lambda = allManifolds[i].m_contacts[j].tangentImpulseSum2 - oldImpulseT;
-
-						if (allManifolds[i].m_contacts[j].lambdaCached && k == 0 && allManifolds[i].m_contacts[j].enableWarmStart)
-						{
-							lambda = 0.8f * allManifolds[i].m_contacts[j].oldTangent2Lambda + 0.2f * lambda;
-						}
-						if (k == constraintMaxNum - 1)
-						{
-							allManifolds[i].m_contacts[j].oldTangent2Lambda = lambda;
-						}
-
-						if (!rigidBodyA->isStatic)
-						{
-							rigidBodyA->velocity = rigidBodyA->velocity + lambda * -allManifolds[i].m_contacts[j].tangent2*(1 / rigidBodyA->mass);
-							rigidBodyA->angularVelocity = rigidBodyA->angularVelocity + rigidBodyA->globalInverseInertiaTensor * neRAxN * lambda;
-						}
-						if (!rigidBodyB->isStatic)
-						{
-							rigidBodyB->velocity = rigidBodyB->velocity + lambda * allManifolds[i].m_contacts[j].tangent2*(1 / rigidBodyB->mass);
-							rigidBodyB->angularVelocity = rigidBodyB->angularVelocity + rigidBodyB->globalInverseInertiaTensor * poRBxN * lambda;
-						}
+						rigidBodyB->velocity = rigidBodyB->velocity + lambda * io_manifold.m_contacts[j].tangent2*(1 / rigidBodyB->mass);
+						rigidBodyB->angularVelocity = rigidBodyB->angularVelocity + rigidBodyB->globalInverseInertiaTensor * poRBxN * lambda;
 					}
 				}
 			}
-		} 
+		}
 	}
 }
\ No newline at end of file
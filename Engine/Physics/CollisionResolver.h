@@ -1,11 +1,15 @@
 #pragma once
 #include "sRigidBodyState.h"
 #include <vector>
+#include "Island.h"
 
 namespace sca2025 
 {
 	namespace Physics 
 	{
-		void CollisionResolver(float i_dt, int k);
+		void CollisionResolver(float i_dt, int k, SolverResidual& io_residual);
+		//i_relax skips warm starting, restitution and the penetration bias
+		void ResolveManifold(ContactManifold3D& io_manifold, float i_dt, int k, bool i_relax, SolverResidual& io_residual);
+		void WarmStartContact(Contact& io_contact);
 	}
 }
\ No newline at end of file
@@ -0,0 +1,362 @@
+#include <algorithm>
+
+#include "ContactSolverSIMD.h"
+#include "PhysicsSimulation.h"
+#include "CollisionResolver.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#else
+#include <xmmintrin.h>
+#endif
+
+//same contact parameters as ResolveManifold
+#define CONTACT_BETA 0.1f
+#define CONTACT_RESTITUTION 0.7f
+#define CONTACT_SLOP_PENETRATION 0.001f
+#define CONTACT_SLOP_RESTITUTION 0.5f
+#define CONTACT_FRICTION 50.0f
+
+namespace sca2025 {
+	namespace Physics {
+		bool simdContactSolver = false;
+
+		namespace {
+#if defined(__AVX__)
+			typedef __m256 simdFloat;
+			inline simdFloat SimdLoad(const float* i_p) { return _mm256_loadu_ps(i_p); }
+			inline void SimdStore(float* o_p, simdFloat i_v) { _mm256_storeu_ps(o_p, i_v); }
+			inline simdFloat SimdSet(float i_v) { return _mm256_set1_ps(i_v); }
+			inline simdFloat SimdAdd(simdFloat a, simdFloat b) { return _mm256_add_ps(a, b); }
+			inline simdFloat SimdSub(simdFloat a, simdFloat b) { return _mm256_sub_ps(a, b); }
+			inline simdFloat SimdMul(simdFloat a, simdFloat b) { return _mm256_mul_ps(a, b); }
+			inline simdFloat SimdMax(simdFloat a, simdFloat b) { return _mm256_max_ps(a, b); }
+			inline simdFloat SimdMin(simdFloat a, simdFloat b) { return _mm256_min_ps(a, b); }
+			inline simdFloat SimdAbs(simdFloat a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+#else
+			typedef __m128 simdFloat;
+			inline simdFloat SimdLoad(const float* i_p) { return _mm_loadu_ps(i_p); }
+			inline void SimdStore(float* o_p, simdFloat i_v) { _mm_storeu_ps(o_p, i_v); }
+			inline simdFloat SimdSet(float i_v) { return _mm_set1_ps(i_v); }
+			inline simdFloat SimdAdd(simdFloat a, simdFloat b) { return _mm_add_ps(a, b); }
+			inline simdFloat SimdSub(simdFloat a, simdFloat b) { return _mm_sub_ps(a, b); }
+			inline simdFloat SimdMul(simdFloat a, simdFloat b) { return _mm_mul_ps(a, b); }
+			inline simdFloat SimdMax(simdFloat a, simdFloat b) { return _mm_max_ps(a, b); }
+			inline simdFloat SimdMin(simdFloat a, simdFloat b) { return _mm_min_ps(a, b); }
+			inline simdFloat SimdAbs(simdFloat a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+#endif
+			inline simdFloat SimdDot(const simdFloat* a, const simdFloat* b)
+			{
+				return SimdAdd(SimdAdd(SimdMul(a[0], b[0]), SimdMul(a[1], b[1])), SimdMul(a[2], b[2]));
+			}
+
+			//padding lanes point at a static body with zero velocity
+			sRigidBodyState CreatePaddingBody()
+			{
+				sRigidBodyState body;
+				body.isStatic = true;
+				return body;
+			}
+			sRigidBodyState paddingBody = CreatePaddingBody();
+
+			struct LaneVelocities {
+				simdFloat vA[3], wA[3], vB[3], wB[3];
+				simdFloat impulseResidual, velocityResidual;
+			};
+
+			void ResizeRow(SoARow& o_row, size_t i_size)
+			{
+				for (int k = 0; k < 3; k++)
+				{
+					o_row.linear[k].assign(i_size, 0.0f);
+					o_row.angularA[k].assign(i_size, 0.0f);
+					o_row.angularB[k].assign(i_size, 0.0f);
+					o_row.inertiaAngularA[k].assign(i_size, 0.0f);
+					o_row.inertiaAngularB[k].assign(i_size, 0.0f);
+				}
+				o_row.effectiveMass.assign(i_size, 0.0f);
+				o_row.inverseEffectiveMass.assign(i_size, 0.0f);
+				o_row.impulseSum.assign(i_size, 0.0f);
+			}
+
+			void SetRow(SoARow& o_row, size_t i_slot, const Math::sVector& i_dir, const Math::sVector& i_rA, const Math::sVector& i_rB,
+				sRigidBodyState* i_A, sRigidBodyState* i_B, float i_impulseSum)
+			{
+				Math::sVector angularA = Math::Cross(-i_rA, i_dir);
+				Math::sVector angularB = Math::Cross(i_rB, i_dir);
+				Math::sVector inertiaAngularA = i_A->globalInverseInertiaTensor * angularA;
+				Math::sVector inertiaAngularB = i_B->globalInverseInertiaTensor * angularB;
+				float effectiveMass = Math::Dot(i_dir, i_dir) * (1 / i_A->mass) + Math::Dot(angularA, inertiaAngularA)
+					+ Math::Dot(i_dir, i_dir) * (1 / i_B->mass) + Math::Dot(angularB, inertiaAngularB);
+				if (i_A->isStatic) inertiaAngularA = Math::sVector();
+				if (i_B->isStatic) inertiaAngularB = Math::sVector();
+
+				const float dir[3] = { i_dir.x, i_dir.y, i_dir.z };
+				const float angA[3] = { angularA.x, angularA.y, angularA.z };
+				const float angB[3] = { angularB.x, angularB.y, angularB.z };
+				const float iangA[3] = { inertiaAngularA.x, inertiaAngularA.y, inertiaAngularA.z };
+				const float iangB[3] = { inertiaAngularB.x, inertiaAngularB.y, inertiaAngularB.z };
+				for (int k = 0; k < 3; k++)
+				{
+					o_row.linear[k][i_slot] = dir[k];
+					o_row.angularA[k][i_slot] = angA[k];
+					o_row.angularB[k][i_slot] = angB[k];
+					o_row.inertiaAngularA[k][i_slot] = iangA[k];
+					o_row.inertiaAngularB[k][i_slot] = iangB[k];
+				}
+				o_row.effectiveMass[i_slot] = effectiveMass;
+				o_row.inverseEffectiveMass[i_slot] = 1.0f / effectiveMass;
+				o_row.impulseSum[i_slot] = i_impulseSum;
+			}
+
+			bool SharesDynamicBody(const ContactRowsSoA& i_rows, int i_batch, int i_lanes, sRigidBodyState* i_A, sRigidBodyState* i_B)
+			{
+				for (int l = 0; l < i_lanes; l++)
+				{
+					size_t slot = static_cast<size_t>(i_batch) * SIMD_WIDTH + l;
+					sRigidBodyState* laneA = i_rows.bodyA[slot];
+					sRigidBodyState* laneB = i_rows.bodyB[slot];
+					if (!i_A->isStatic && (i_A == laneA || i_A == laneB)) return true;
+					if (!i_B->isStatic && (i_B == laneA || i_B == laneB)) return true;
+				}
+				return false;
+			}
+
+			//applies one row to all lanes, the normal row gets the penetration bias, friction rows the clamp bound
+			void SolveRow(SoARow& io_row, size_t i_offset, LaneVelocities& io_v, simdFloat i_inverseMassA, simdFloat i_inverseMassB,
+				const simdFloat* i_penetrationBias, const simdFloat& i_restitution, const simdFloat* i_frictionLimit)
+			{
+				simdFloat linear[3], angularA[3], angularB[3];
+				for (int k = 0; k < 3; k++)
+				{
+					linear[k] = SimdLoad(&io_row.linear[k][i_offset]);
+					angularA[k] = SimdLoad(&io_row.angularA[k][i_offset]);
+					angularB[k] = SimdLoad(&io_row.angularB[k][i_offset]);
+				}
+				simdFloat relative[3] = { SimdSub(io_v.vB[0], io_v.vA[0]), SimdSub(io_v.vB[1], io_v.vA[1]), SimdSub(io_v.vB[2], io_v.vA[2]) };
+				simdFloat JV = SimdAdd(SimdDot(linear, relative), SimdAdd(SimdDot(angularA, io_v.wA), SimdDot(angularB, io_v.wB)));
+
+				simdFloat zero = SimdSet(0.0f);
+				simdFloat lambda;
+				simdFloat impulseSum = SimdLoad(&io_row.impulseSum[i_offset]);
+				simdFloat oldImpulseSum = impulseSum;
+				if (i_penetrationBias)
+				{
+					//normal row, b = -beta / dt * penetration - CR * max(-JV - SlopR, 0)
+					simdFloat restitution = SimdMul(i_restitution, SimdMax(SimdSub(SimdSub(zero, JV), SimdSet(CONTACT_SLOP_RESTITUTION)), zero));
+					simdFloat b = SimdSub(SimdSub(zero, *i_penetrationBias), restitution);
+					lambda = SimdMul(SimdSub(SimdSub(zero, JV), b), SimdLoad(&io_row.inverseEffectiveMass[i_offset]));
+					impulseSum = SimdMax(SimdAdd(impulseSum, lambda), zero);
+				}
+				else
+				{
+					lambda = SimdMul(SimdSub(zero, JV), SimdLoad(&io_row.inverseEffectiveMass[i_offset]));
+					impulseSum = SimdMin(SimdMax(SimdAdd(impulseSum, lambda), SimdSub(zero, *i_frictionLimit)), *i_frictionLimit);
+				}
+				lambda = SimdSub(impulseSum, oldImpulseSum);
+				SimdStore(&io_row.impulseSum[i_offset], impulseSum);
+				//padding lanes have zero effective mass and never change their impulse
+				simdFloat absLambda = SimdAbs(lambda);
+				io_v.impulseResidual = SimdMax(io_v.impulseResidual, absLambda);
+				io_v.velocityResidual = SimdMax(io_v.velocityResidual, SimdMul(absLambda, SimdLoad(&io_row.effectiveMass[i_offset])));
+
+				simdFloat lambdaA = SimdMul(lambda, i_inverseMassA);
+				simdFloat lambdaB = SimdMul(lambda, i_inverseMassB);
+				for (int k = 0; k < 3; k++)
+				{
+					io_v.vA[k] = SimdSub(io_v.vA[k], SimdMul(linear[k], lambdaA));
+					io_v.vB[k] = SimdAdd(io_v.vB[k], SimdMul(linear[k], lambdaB));
+					io_v.wA[k] = SimdAdd(io_v.wA[k], SimdMul(SimdLoad(&io_row.inertiaAngularA[k][i_offset]), lambda));
+					io_v.wB[k] = SimdAdd(io_v.wB[k], SimdMul(SimdLoad(&io_row.inertiaAngularB[k][i_offset]), lambda));
+				}
+			}
+		}
+
+		void BuildContactRows(const std::vector<SolverConstraint>& i_constraints, bool i_disjoint, float i_dt, bool i_relax, ContactRowsSoA& o_rows)
+		{
+			std::vector<ContactManifold3D*> manifolds;
+			for (size_t i = 0; i < i_constraints.size(); i++)
+			{
+				if (i_constraints[i].type == ContactConstraint) manifolds.push_back(&allManifolds[i_constraints[i].index]);
+			}
+
+			//assign every contact a slot
+			o_rows.groupStart.clear();
+			o_rows.numBatches = 0;
+			o_rows.bodyA.clear();
+			o_rows.bodyB.clear();
+			o_rows.contacts.clear();
+			if (i_disjoint)
+			{
+				//manifolds of a color share no dynamic body, SIMD_WIDTH manifolds form a group and contact j of each goes to batch j
+				for (size_t first = 0; first < manifolds.size(); first += SIMD_WIDTH)
+				{
+					o_rows.groupStart.push_back(o_rows.numBatches);
+					int groupBatches = 0;
+					for (int l = 0; l < SIMD_WIDTH && first + l < manifolds.size(); l++)
+					{
+						ContactManifold3D& manifold = *manifolds[first + l];
+						groupBatches = std::max(groupBatches, manifold.numContacts);
+					}
+					o_rows.numBatches += groupBatches;
+					o_rows.bodyA.resize(static_cast<size_t>(o_rows.numBatches) * SIMD_WIDTH, &paddingBody);
+					o_rows.bodyB.resize(static_cast<size_t>(o_rows.numBatches) * SIMD_WIDTH, &paddingBody);
+					o_rows.contacts.resize(static_cast<size_t>(o_rows.numBatches) * SIMD_WIDTH, nullptr);
+					for (int l = 0; l < SIMD_WIDTH && first + l < manifolds.size(); l++)
+					{
+						ContactManifold3D& manifold = *manifolds[first + l];
+						for (int j = 0; j < manifold.numContacts; j++)
+						{
+							size_t slot = static_cast<size_t>(o_rows.groupStart.back() + j) * SIMD_WIDTH + l;
+							o_rows.contacts[slot] = &manifold.m_contacts[j];
+							o_rows.bodyA[slot] = manifold.m_contacts[j].colliderA->m_pParentRigidBody;
+							o_rows.bodyB[slot] = manifold.m_contacts[j].colliderB->m_pParentRigidBody;
+						}
+					}
+				}
+			}
+			else
+			{
+				//greedy packing into the first batch without a shared dynamic body
+				o_rows.groupStart.push_back(0);
+				std::vector<int> laneCount;
+				int firstOpenBatch = 0;
+				for (size_t i = 0; i < manifolds.size(); i++)
+				{
+					ContactManifold3D& manifold = *manifolds[i];
+					for (int j = 0; j < manifold.numContacts; j++)
+					{
+						sRigidBodyState* pA = manifold.m_contacts[j].colliderA->m_pParentRigidBody;
+						sRigidBodyState* pB = manifold.m_contacts[j].colliderB->m_pParentRigidBody;
+						int batch = firstOpenBatch;
+						while (batch < o_rows.numBatches && (laneCount[batch] == SIMD_WIDTH || SharesDynamicBody(o_rows, batch, laneCount[batch], pA, pB))) batch++;
+						if (batch == o_rows.numBatches)
+						{
+							o_rows.numBatches++;
+							laneCount.push_back(0);
+							o_rows.bodyA.resize(static_cast<size_t>(o_rows.numBatches) * SIMD_WIDTH, &paddingBody);
+							o_rows.bodyB.resize(static_cast<size_t>(o_rows.numBatches) * SIMD_WIDTH, &paddingBody);
+							o_rows.contacts.resize(static_cast<size_t>(o_rows.numBatches) * SIMD_WIDTH, nullptr);
+						}
+						size_t slot = static_cast<size_t>(batch) * SIMD_WIDTH + laneCount[batch];
+						laneCount[batch]++;
+						o_rows.contacts[slot] = &manifold.m_contacts[j];
+						o_rows.bodyA[slot] = pA;
+						o_rows.bodyB[slot] = pB;
+						while (firstOpenBatch < o_rows.numBatches && laneCount[firstOpenBatch] == SIMD_WIDTH) firstOpenBatch++;
+					}
+				}
+			}
+			o_rows.groupStart.push_back(o_rows.numBatches);
+
+			//fill the rows
+			size_t size = static_cast<size_t>(o_rows.numBatches) * SIMD_WIDTH;
+			ResizeRow(o_rows.normal, size);
+			ResizeRow(o_rows.tangent1, size);
+			ResizeRow(o_rows.tangent2, size);
+			o_rows.inverseMassA.assign(size, 0.0f);
+			o_rows.inverseMassB.assign(size, 0.0f);
+			o_rows.penetrationBias.assign(size, 0.0f);
+			o_rows.restitution = i_relax ? 0.0f : CONTACT_RESTITUTION;
+			for (size_t slot = 0; slot < size; slot++)
+			{
+				Contact* pContact = o_rows.contacts[slot];
+				if (!pContact) continue;
+				if (!i_relax) WarmStartContact(*pContact);
+				sRigidBodyState* pA = o_rows.bodyA[slot];
+				sRigidBodyState* pB = o_rows.bodyB[slot];
+				Math::sVector rA = pContact->globalPositionA - pA->position;
+				Math::sVector rB = pContact->globalPositionB - pB->position;
+				SetRow(o_rows.normal, slot, pContact->normal, rA, rB, pA, pB, pContact->normalImpulseSum);
+				SetRow(o_rows.tangent1, slot, pContact->tangent1, rA, rB, pA, pB, pContact->tangentImpulseSum1);
+				SetRow(o_rows.tangent2, slot, pContact->tangent2, rA, rB, pA, pB, pContact->tangentImpulseSum2);
+				o_rows.inverseMassA[slot] = pA->isStatic ? 0.0f : 1 / pA->mass;
+				o_rows.inverseMassB[slot] = pB->isStatic ? 0.0f : 1 / pB->mass;
+				if (!i_relax) o_rows.penetrationBias[slot] = CONTACT_BETA / i_dt * std::max(pContact->depth - CONTACT_SLOP_PENETRATION, 0.0f);
+			}
+		}
+
+		void SolveContactRows(ContactRowsSoA& io_rows, int i_group, SolverResidual& io_residual)
+		{
+			for (int batch = io_rows.groupStart[i_group]; batch < io_rows.groupStart[i_group + 1]; batch++)
+			{
+				size_t offset = static_cast<size_t>(batch) * SIMD_WIDTH;
+
+				//gather
+				float lanes[12][SIMD_WIDTH];
+				for (int l = 0; l < SIMD_WIDTH; l++)
+				{
+					const sRigidBodyState* pA = io_rows.bodyA[offset + l];
+					const sRigidBodyState* pB = io_rows.bodyB[offset + l];
+					lanes[0][l] = pA->velocity.x; lanes[1][l] = pA->velocity.y; lanes[2][l] = pA->velocity.z;
+					lanes[3][l] = pA->angularVelocity.x; lanes[4][l] = pA->angularVelocity.y; lanes[5][l] = pA->angularVelocity.z;
+					lanes[6][l] = pB->velocity.x; lanes[7][l] = pB->velocity.y; lanes[8][l] = pB->velocity.z;
+					lanes[9][l] = pB->angularVelocity.x; lanes[10][l] = pB->angularVelocity.y; lanes[11][l] = pB->angularVelocity.z;
+				}
+				LaneVelocities v;
+				for (int k = 0; k < 3; k++)
+				{
+					v.vA[k] = SimdLoad(lanes[k]);
+					v.wA[k] = SimdLoad(lanes[3 + k]);
+					v.vB[k] = SimdLoad(lanes[6 + k]);
+					v.wB[k] = SimdLoad(lanes[9 + k]);
+				}
+				v.impulseResidual = SimdSet(0.0f);
+				v.velocityResidual = SimdSet(0.0f);
+
+				simdFloat inverseMassA = SimdLoad(&io_rows.inverseMassA[offset]);
+				simdFloat inverseMassB = SimdLoad(&io_rows.inverseMassB[offset]);
+				simdFloat penetrationBias = SimdLoad(&io_rows.penetrationBias[offset]);
+				SolveRow(io_rows.normal, offset, v, inverseMassA, inverseMassB, &penetrationBias, SimdSet(io_rows.restitution), nullptr);
+				simdFloat frictionLimit = SimdMul(SimdLoad(&io_rows.normal.impulseSum[offset]), SimdSet(CONTACT_FRICTION));
+				SolveRow(io_rows.tangent1, offset, v, inverseMassA, inverseMassB, nullptr, SimdSet(0.0f), &frictionLimit);
+				SolveRow(io_rows.tangent2, offset, v, inverseMassA, inverseMassB, nullptr, SimdSet(0.0f), &frictionLimit);
+
+				//scatter, lanes never share a dynamic body
+				for (int k = 0; k < 3; k++)
+				{
+					SimdStore(lanes[k], v.vA[k]);
+					SimdStore(lanes[3 + k], v.wA[k]);
+					SimdStore(lanes[6 + k], v.vB[k]);
+					SimdStore(lanes[9 + k], v.wB[k]);
+				}
+				float impulseResidual[SIMD_WIDTH], velocityResidual[SIMD_WIDTH];
+				SimdStore(impulseResidual, v.impulseResidual);
+				SimdStore(velocityResidual, v.velocityResidual);
+				for (int l = 0; l < SIMD_WIDTH; l++)
+				{
+					io_residual.Add(impulseResidual[l], velocityResidual[l]);
+					if (!io_rows.contacts[offset + l]) continue;
+					sRigidBodyState* pA = io_rows.bodyA[offset + l];
+					sRigidBodyState* pB = io_rows.bodyB[offset + l];
+					if (!pA->isStatic)
+					{
+						pA->velocity = Math::sVector(lanes[0][l], lanes[1][l], lanes[2][l]);
+						pA->angularVelocity = Math::sVector(lanes[3][l], lanes[4][l], lanes[5][l]);
+					}
+					if (!pB->isStatic)
+					{
+						pB->velocity = Math::sVector(lanes[6][l], lanes[7][l], lanes[8][l]);
+						pB->angularVelocity = Math::sVector(lanes[9][l], lanes[10][l], lanes[11][l]);
+					}
+				}
+			}
+		}
+
+		void FinishContactRows(ContactRowsSoA& io_rows)
+		{
+			for (size_t slot = 0; slot < io_rows.contacts.size(); slot++)
+			{
+				Contact* pContact = io_rows.contacts[slot];
+				if (!pContact) continue;
+				pContact->normalImpulseSum = io_rows.normal.impulseSum[slot];
+				pContact->tangentImpulseSum1 = io_rows.tangent1.impulseSum[slot];
+				pContact->tangentImpulseSum2 = io_rows.tangent2.impulseSum[slot];
+				pContact->oldNormalLambda = pContact->normalImpulseSum;
+				pContact->oldTangent1Lambda = pContact->tangentImpulseSum1;
+				pContact->oldTangent2Lambda = pContact->tangentImpulseSum2;
+				pContact->lambdaCached = true;
+			}
+		}
+	}
+}
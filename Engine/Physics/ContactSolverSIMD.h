@@ -0,0 +1,54 @@
+#pragma once
+#include <vector>
+#include "Island.h"
+
+//lanes per batch, 8 when the compiler targets AVX
+#if defined(__AVX__)
+#define SIMD_WIDTH 8
+#else
+#define SIMD_WIDTH 4
+#endif
+
+namespace sca2025 {
+	namespace Physics {
+		struct Contact;
+
+		//one constraint row of every lane, batch b lane l is element b * SIMD_WIDTH + l
+		struct SoARow {
+			std::vector<float> linear[3];
+			std::vector<float> angularA[3];
+			std::vector<float> angularB[3];
+			std::vector<float> inertiaAngularA[3];//globalInverseInertiaTensor * angularA, zero for static bodies
+			std::vector<float> inertiaAngularB[3];
+			std::vector<float> effectiveMass;//velocity change per unit impulse, J * M^-1 * J^T
+			std::vector<float> inverseEffectiveMass;
+			std::vector<float> impulseSum;
+		};
+
+		//contacts packed into batches whose lanes never share a dynamic body
+		//batches inside a group run in order, different groups are independent when built from a color
+		struct ContactRowsSoA {
+			SoARow normal;
+			SoARow tangent1;
+			SoARow tangent2;
+			std::vector<float> inverseMassA;//zero for static bodies
+			std::vector<float> inverseMassB;
+			std::vector<float> penetrationBias;
+			float restitution = 0.0f;
+			std::vector<sRigidBodyState*> bodyA;
+			std::vector<sRigidBodyState*> bodyB;
+			std::vector<Contact*> contacts;//nullptr for padding lanes
+			std::vector<int> groupStart;//first batch of every group, plus the end
+			int numBatches = 0;
+		};
+
+		extern bool simdContactSolver;//off by default, the scalar contact loop stays the reference path
+
+		//warm starts the contacts and packs them, i_disjoint means the manifolds share no dynamic body (a color)
+		//i_relax skips warm starting, restitution and the penetration bias
+		void BuildContactRows(const std::vector<SolverConstraint>& i_constraints, bool i_disjoint, float i_dt, bool i_relax, ContactRowsSoA& o_rows);
+		void SolveContactRows(ContactRowsSoA& io_rows, int i_group, SolverResidual& io_residual);
+		//writes the accumulated impulses back for warm starting
+		void FinishContactRows(ContactRowsSoA& io_rows);
+	}
+}
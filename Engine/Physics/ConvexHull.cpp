@@ -0,0 +1,203 @@
+#include <cmath>
+#include <algorithm>
+
+#include "ConvexHull.h"
+#include <Engine/Concurrency/cMutex.h>
+
+namespace sca2025 {
+	namespace Physics {
+		namespace {
+			//weak references, a hull is freed once its last collider is gone
+			std::vector<std::weak_ptr<const ConvexHull>> hullCache;
+			Concurrency::cMutex hullCacheMutex;
+
+			bool SameVertex(const Math::sVector& i_a, const Math::sVector& i_b)
+			{
+				return i_a.x == i_b.x && i_a.y == i_b.y && i_a.z == i_b.z;
+			}
+
+			bool SameShape(const ConvexHull& i_hull, const std::vector<Math::sVector>& i_vertices, const std::vector<std::vector<int>>& i_faces)
+			{
+				if (i_hull.vertices.size() != i_vertices.size() || i_hull.faces.size() != i_faces.size()) return false;
+				for (size_t i = 0; i < i_vertices.size(); i++)
+				{
+					if (!SameVertex(i_hull.vertices[i], i_vertices[i])) return false;
+				}
+				for (size_t f = 0; f < i_faces.size(); f++)
+				{
+					const HullFace& face = i_hull.faces[f];
+					if (face.numIndices != static_cast<int>(i_faces[f].size())) return false;
+					for (int k = 0; k < face.numIndices; k++)
+					{
+						if (i_hull.faceIndices[face.firstIndex + k] != i_faces[f][k]) return false;
+					}
+				}
+				return true;
+			}
+
+			ConvexHull* BuildHull(const std::vector<Math::sVector>& i_vertices, const std::vector<std::vector<int>>& i_faces)
+			{
+				ConvexHull* pHull = new ConvexHull();
+				ConvexHull& hull = *pHull;
+				hull.vertices = i_vertices;
+
+				//local AABB
+				if (!i_vertices.empty())
+				{
+					Math::sVector minimum = i_vertices[0], maximum = i_vertices[0];
+					for (size_t i = 1; i < i_vertices.size(); i++)
+					{
+						minimum = Math::sVector(std::min(minimum.x, i_vertices[i].x), std::min(minimum.y, i_vertices[i].y), std::min(minimum.z, i_vertices[i].z));
+						maximum = Math::sVector(std::max(maximum.x, i_vertices[i].x), std::max(maximum.y, i_vertices[i].y), std::max(maximum.z, i_vertices[i].z));
+					}
+					hull.boxCenter = (minimum + maximum) * 0.5f;
+					hull.boxExtends = (maximum - minimum) * 0.5f;
+				}
+
+				//faces, normals from Newell's method so quads that are not exactly planar still get a stable normal
+				for (size_t f = 0; f < i_faces.size(); f++)
+				{
+					HullFace face;
+					face.firstIndex = static_cast<int>(hull.faceIndices.size());
+					face.numIndices = static_cast<int>(i_faces[f].size());
+					Math::sVector normal;
+					for (int k = 0; k < face.numIndices; k++)
+					{
+						const Math::sVector& current = i_vertices[i_faces[f][k]];
+						const Math::sVector& next = i_vertices[i_faces[f][(k + 1) % face.numIndices]];
+						normal.x += (current.y - next.y) * (current.z + next.z);
+						normal.y += (current.z - next.z) * (current.x + next.x);
+						normal.z += (current.x - next.x) * (current.y + next.y);
+						hull.faceIndices.push_back(i_faces[f][k]);
+					}
+					face.normal = normal.GetLengthSQ() > 0.0f ? normal.GetNormalized() : normal;
+					hull.faces.push_back(face);
+				}
+
+				//edges, every edge is shared by the two faces that walk it in opposite directions
+				for (size_t f = 0; f < i_faces.size(); f++)
+				{
+					int count = static_cast<int>(i_faces[f].size());
+					for (int k = 0; k < count; k++)
+					{
+						int v0 = i_faces[f][k];
+						int v1 = i_faces[f][(k + 1) % count];
+						bool found = false;
+						for (size_t e = 0; e < hull.edges.size(); e++)
+						{
+							HullEdge& edge = hull.edges[e];
+							if ((edge.vertex0 == v0 && edge.vertex1 == v1) || (edge.vertex0 == v1 && edge.vertex1 == v0))
+							{
+								edge.face1 = static_cast<int>(f);
+								found = true;
+								break;
+							}
+						}
+						if (!found)
+						{
+							HullEdge edge;
+							edge.vertex0 = v0;
+							edge.vertex1 = v1;
+							edge.face0 = static_cast<int>(f);
+							edge.face1 = -1;
+							hull.edges.push_back(edge);
+						}
+					}
+				}
+
+				//vertex adjacency in compressed rows
+				if (!hull.edges.empty())
+				{
+					std::vector<int> degree(i_vertices.size(), 0);
+					for (size_t e = 0; e < hull.edges.size(); e++)
+					{
+						degree[hull.edges[e].vertex0]++;
+						degree[hull.edges[e].vertex1]++;
+					}
+					hull.neighborStart.resize(i_vertices.size() + 1, 0);
+					for (size_t i = 0; i < i_vertices.size(); i++) hull.neighborStart[i + 1] = hull.neighborStart[i] + degree[i];
+					hull.neighbors.resize(hull.neighborStart.back());
+					std::vector<int> fill(hull.neighborStart.begin(), hull.neighborStart.end() - 1);
+					for (size_t e = 0; e < hull.edges.size(); e++)
+					{
+						hull.neighbors[fill[hull.edges[e].vertex0]++] = hull.edges[e].vertex1;
+						hull.neighbors[fill[hull.edges[e].vertex1]++] = hull.edges[e].vertex0;
+					}
+				}
+				return pHull;
+			}
+		}
+
+		int ConvexHull::SupportVertex(const Math::sVector& i_localDir) const
+		{
+			int selection = 0;
+			float maxDist = Math::Dot(vertices[0], i_localDir);
+			if (neighbors.empty())
+			{
+				for (size_t i = 1; i < vertices.size(); i++)
+				{
+					float dist = Math::Dot(vertices[i], i_localDir);
+					if (dist > maxDist)
+					{
+						maxDist = dist;
+						selection = static_cast<int>(i);
+					}
+				}
+				return selection;
+			}
+			//on a convex hull a vertex without a better neighbor is the global maximum
+			bool improved = true;
+			while (improved)
+			{
+				improved = false;
+				for (int k = neighborStart[selection]; k < neighborStart[selection + 1]; k++)
+				{
+					float dist = Math::Dot(vertices[neighbors[k]], i_localDir);
+					if (dist > maxDist)
+					{
+						maxDist = dist;
+						selection = neighbors[k];
+						improved = true;
+					}
+				}
+			}
+			return selection;
+		}
+
+		std::shared_ptr<const ConvexHull> AcquireConvexHull(const std::vector<Math::sVector>& i_vertices, const std::vector<std::vector<int>>& i_faces)
+		{
+			hullCacheMutex.Lock();
+			std::shared_ptr<const ConvexHull> result;
+			for (size_t i = 0; i < hullCache.size() && !result; i++)
+			{
+				std::shared_ptr<const ConvexHull> cached = hullCache[i].lock();
+				if (cached && SameShape(*cached, i_vertices, i_faces)) result = cached;
+			}
+			if (!result)
+			{
+				//drop the hulls nobody uses anymore before adding a new one
+				hullCache.erase(std::remove_if(hullCache.begin(), hullCache.end(), [](const std::weak_ptr<const ConvexHull>& i_hull) { return i_hull.expired(); }), hullCache.end());
+				result = std::shared_ptr<const ConvexHull>(BuildHull(i_vertices, i_faces));
+				hullCache.push_back(result);
+			}
+			hullCacheMutex.Unlock();
+			return result;
+		}
+
+		std::shared_ptr<const ConvexHull> AcquireBoxHull(const Math::sVector& i_extends)
+		{
+			const Math::sVector& e = i_extends;
+			std::vector<Math::sVector> vertices = {
+				Math::sVector(e.x, e.y, e.z), Math::sVector(e.x, e.y, -e.z), Math::sVector(-e.x, e.y, -e.z), Math::sVector(-e.x, e.y, e.z),
+				Math::sVector(e.x, -e.y, e.z), Math::sVector(e.x, -e.y, -e.z), Math::sVector(-e.x, -e.y, -e.z), Math::sVector(-e.x, -e.y, e.z) };
+			std::vector<std::vector<int>> faces = {
+				{ 0, 1, 2, 3 },//+y
+				{ 4, 7, 6, 5 },//-y
+				{ 0, 4, 5, 1 },//+x
+				{ 3, 2, 6, 7 },//-x
+				{ 0, 3, 7, 4 },//+z
+				{ 1, 5, 6, 2 } };//-z
+			return AcquireConvexHull(vertices, faces);
+		}
+	}
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <Engine/Math/sVector.h>
+
+namespace sca2025 {
+	namespace Physics {
+		struct HullFace {
+			Math::sVector normal;//outward, local space
+			int firstIndex;//into ConvexHull::faceIndices, counter clockwise seen from outside
+			int numIndices;
+		};
+
+		struct HullEdge {
+			int vertex0, vertex1;
+			int face0, face1;//-1 when the edge only has one face
+		};
+
+		//immutable local space shape data shared by every collider of the same shape
+		//spheres store the center in vertices[0] and a radius vector in vertices[1], planes a point and the normal
+		struct ConvexHull {
+			std::vector<Math::sVector> vertices;
+			std::vector<HullFace> faces;
+			std::vector<int> faceIndices;
+			std::vector<HullEdge> edges;
+			//vertices connected to vertex i by an edge are neighbors[neighborStart[i]] to neighbors[neighborStart[i + 1] - 1]
+			std::vector<int> neighborStart;
+			std::vector<int> neighbors;
+			Math::sVector boxCenter;//local AABB of the vertices
+			Math::sVector boxExtends;
+
+			//vertex furthest along i_localDir, hill climbs the edge graph when it exists
+			int SupportVertex(const Math::sVector& i_localDir) const;
+		};
+
+		//returns the cached hull with the same vertices and faces, or builds a new one
+		//i_faces may be empty, the hull then has no adjacency and support queries test every vertex
+		std::shared_ptr<const ConvexHull> AcquireConvexHull(const std::vector<Math::sVector>& i_vertices, const std::vector<std::vector<int>>& i_faces);
+		//box of half extents i_extends, vertices in the order Collider::InitializeCollider always used
+		std::shared_ptr<const ConvexHull> AcquireBoxHull(const Math::sVector& i_extends);
+	}
+}
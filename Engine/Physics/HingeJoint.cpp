@@ -1,3 +1,5 @@
+#include <cmath>
+
 #include "HingeJoint.h"
 #include "Engine/Math/sVector.h"
 #include "Engine/Math/cMatrix_transformation.h"
@@ -9,24 +11,21 @@ namespace sca2025
 	{
 		void HingeJointsSolver(float i_dt)
 		{
+			SolverResidual residual;
 			for (size_t i = 0; i < allHingeJoints.size(); i++)
 			{
-				allHingeJoints[i].ResolveHingJoint(i_dt);
+				allHingeJoints[i].ResolveHingJoint(i_dt, residual);
 			}
 		}
 	}
 }
 
-void sca2025::Physics::HingeJoint::ResolveHingJoint(float i_dt)
+void sca2025::Physics::HingeJoint::PrepareRow(float i_dt, HingeJointRow& o_row)
 {
-	//ball joint solver
+	//ball joint rows
 	{
-		Vector3f v1, v2, w1, w2, x1, x2;
-		Math::NativeVector2EigenVector(pActorA->m_State.velocity, v1);
-		Math::NativeVector2EigenVector(pActorA->m_State.angularVelocity, w1);
+		Vector3f x1, x2;
 		Math::NativeVector2EigenVector(pActorA->m_State.position, x1);
-		Math::NativeVector2EigenVector(pActorB->m_State.velocity, v2);
-		Math::NativeVector2EigenVector(pActorB->m_State.angularVelocity, w2);
 		Math::NativeVector2EigenVector(pActorB->m_State.position, x2);
 
 		Math::cMatrix_transformation local2WorldRotA(pActorA->m_State.orientation, Math::sVector(0.0f, 0.0f, 0.0f));
@@ -54,8 +53,6 @@ void sca2025::Physics::HingeJoint::ResolveHingJoint(float i_dt)
 
 		Math::sVector a1 = local2WorldRotA * axisLocaA;
 		a1.Normalize();
-		Math::sVector a2 = local2WorldRotB * axisLocaB;
-		a2.Normalize();
 		Math::sVector b2 = local2WorldRotB * localB2;
 		b2.Normalize();
 		Math::sVector c2 = local2WorldRotB * localC2;
@@ -86,8 +83,6 @@ void sca2025::Physics::HingeJoint::ResolveHingJoint(float i_dt)
 
 		MatrixXf K(5, 5);
 		K = J * M_inverse * J.transpose();
-		//Matrix3f K;
-		//K = (1.0f / m1) * I + r1Skew * inertiaInv_1 * r1Skew.transpose() + (1.0f / m2) * I + r2Skew * inertiaInv_2 * r2Skew.transpose();
 
 		Vector3f b_0;
 		float beta_0 = 1.0f;//point correction strength
@@ -99,43 +94,20 @@ void sca2025::Physics::HingeJoint::ResolveHingJoint(float i_dt)
 		C_1(1) = Math::Dot(a1, c2);
 		float beta_1 = 1.0f;//axis correction strength
 		b_1 = (beta_1 / i_dt) * C_1;
-		VectorXf b(5);
-		b.segment(0, 3) = b_0;
-		b.segment(3, 2) = b_1;
-
-		VectorXf V(12);
-		V.segment(0, 3) = v1;
-		V.segment(3, 3) = w1;
-		V.segment(6, 3) = v2;
-		V.segment(9, 3) = w2;
-		VectorXf lambda(5);
-		lambda = K.inverse() * (-J * V - b);
-
-		VectorXf delta_V(12);
-		delta_V = M_inverse * J.transpose() * lambda;
-
-		Vector3f delta_v1 = delta_V.segment(0, 3);
-		Math::sVector native_delta_v1 = Math::EigenVector2nativeVector(delta_v1);
-		Vector3f delta_w1 = delta_V.segment(3, 3);
-		Math::sVector native_delta_w1 = Math::EigenVector2nativeVector(delta_w1);
-		Vector3f delta_v2 = delta_V.segment(6, 3);
-		Math::sVector native_delta_v2 = Math::EigenVector2nativeVector(delta_v2);
-		Vector3f delta_w2 = delta_V.segment(9, 3);
-		Math::sVector native_delta_w2 = Math::EigenVector2nativeVector(delta_w2);
-
-		if (!pActorA->m_State.isStatic)
-		{
-			pActorA->m_State.velocity += native_delta_v1;
-			pActorA->m_State.angularVelocity += native_delta_w1;
-		}
-		if (!pActorB->m_State.isStatic)
-		{
-			pActorB->m_State.velocity += native_delta_v2;
-			pActorB->m_State.angularVelocity += native_delta_w2;
-		}
 
+		o_row.pA = &pActorA->m_State;
+		o_row.pB = &pActorB->m_State;
+		o_row.J = J;
+		o_row.inverseK = K.ldlt().solve(MatrixXf::Identity(5, 5));
+		o_row.impulseResponse = M_inverse * J.transpose();
+		//static bodies keep their velocity
+		if (pActorA->m_State.isStatic) o_row.impulseResponse.block<6, 5>(0, 0).setZero();
+		if (pActorB->m_State.isStatic) o_row.impulseResponse.block<6, 5>(6, 0).setZero();
+		o_row.bias.segment<3>(0) = b_0;
+		o_row.bias.segment<2>(3) = b_1;
 	}
-	//motor solver
+	//motor row
+	o_row.motorEnable = motorEnable;
 	if (motorEnable)
 	{
 		Math::cMatrix_transformation local2WorldRotA(pActorA->m_State.orientation, Math::sVector(0, 0, 0));
@@ -144,28 +116,69 @@ void sca2025::Physics::HingeJoint::ResolveHingJoint(float i_dt)
 		Math::sVector a2 = local2WorldRotB * axisLocaB;
 		Math::sVector a = (a1 + a2) / 2.0f;
 		a.Normalize();
-		Math::sVector w1 = pActorA->m_State.angularVelocity;
-		Math::sVector w2 = pActorB->m_State.angularVelocity;
-		float JVb = Math::Dot(a, w2 - w1) + w_motor_B2A;
 		float K;
 		K = Math::Dot(a, pActorA->m_State.globalInverseInertiaTensor * a) + Math::Dot(a, pActorB->m_State.globalInverseInertiaTensor * a);
-		float lambda = -JVb / K;
+		o_row.motorAxis = a;
+		o_row.motorResponseA = pActorA->m_State.isStatic ? Math::sVector() : pActorA->m_State.globalInverseInertiaTensor * -a;
+		o_row.motorResponseB = pActorB->m_State.isStatic ? Math::sVector() : pActorB->m_State.globalInverseInertiaTensor * a;
+		o_row.motorInverseK = 1.0f / K;
+		o_row.motorSpeed = w_motor_B2A;
+	}
+}
 
-		Math::sVector native_delta_w1 = pActorA->m_State.globalInverseInertiaTensor * -a * lambda;
-		Math::sVector native_delta_w2 = pActorB->m_State.globalInverseInertiaTensor * a * lambda;
-		if (!pActorA->m_State.isStatic)
+void sca2025::Physics::HingeJoint::ResolveHingJoint(float i_dt, SolverResidual& io_residual)
+{
+	HingeJointRow row;
+	PrepareRow(i_dt, row);
+	SolveHingeJointRow(row, io_residual);
+}
+
+void sca2025::Physics::SolveHingeJointRow(HingeJointRow& io_row, SolverResidual& io_residual)
+{
+	sRigidBodyState& stateA = *io_row.pA;
+	sRigidBodyState& stateB = *io_row.pB;
+	//ball joint solver
+	{
+		Matrix<float, 12, 1> V;
+		V.segment<3>(0) = Math::NativeVector2EigenVector(stateA.velocity);
+		V.segment<3>(3) = Math::NativeVector2EigenVector(stateA.angularVelocity);
+		V.segment<3>(6) = Math::NativeVector2EigenVector(stateB.velocity);
+		V.segment<3>(9) = Math::NativeVector2EigenVector(stateB.angularVelocity);
+
+		Matrix<float, 5, 1> velocityError = io_row.J * V + io_row.bias;
+		Matrix<float, 5, 1> lambda = io_row.inverseK * -velocityError;
+		io_residual.Add(lambda.cwiseAbs().maxCoeff(), velocityError.cwiseAbs().maxCoeff());
+
+		Matrix<float, 12, 1> delta_V = io_row.impulseResponse * lambda;
+		Vector3f delta_v1 = delta_V.segment<3>(0);
+		Vector3f delta_w1 = delta_V.segment<3>(3);
+		Vector3f delta_v2 = delta_V.segment<3>(6);
+		Vector3f delta_w2 = delta_V.segment<3>(9);
+		//static bodies are shared by islands solved in parallel, they are never written
+		if (!stateA.isStatic)
+		{
+			stateA.velocity += Math::EigenVector2nativeVector(delta_v1);
+			stateA.angularVelocity += Math::EigenVector2nativeVector(delta_w1);
+		}
+		if (!stateB.isStatic)
+		{
+			stateB.velocity += Math::EigenVector2nativeVector(delta_v2);
+			stateB.angularVelocity += Math::EigenVector2nativeVector(delta_w2);
+		}
+	}
+	//motor solver
+	if (io_row.motorEnable)
+	{
+		float JVb = Math::Dot(io_row.motorAxis, stateB.angularVelocity - stateA.angularVelocity) + io_row.motorSpeed;
+		float lambda = -JVb * io_row.motorInverseK;
+		io_residual.Add(std::abs(lambda), std::abs(JVb));
+		if (!stateA.isStatic)
 		{
-			pActorA->m_State.angularVelocity += native_delta_w1;
+			stateA.angularVelocity += io_row.motorResponseA * lambda;
 		}
-		if (!pActorB->m_State.isStatic)
+		if (!stateB.isStatic)
 		{
-			pActorB->m_State.angularVelocity += native_delta_w2;
+			stateB.angularVelocity += io_row.motorResponseB * lambda;
 		}
 	}
-	/*
-	pActorA->m_State.velocity *= 0.9999f;
-	pActorA->m_State.angularVelocity *= 0.9999f;
-	pActorB->m_State.velocity *= 0.9999f;
-	pActorB->m_State.angularVelocity *= 0.9999f;
-	*/
 }
\ No newline at end of file
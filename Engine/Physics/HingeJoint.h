@@ -2,6 +2,7 @@
 #include "Engine/GameCommon/GameObject.h"
 #include <Engine/Math/sVector.h>
 #include "External/EigenLibrary/Eigen/Dense"
+#include "Island.h"
 
 using namespace Eigen;
 
@@ -9,6 +10,24 @@ namespace sca2025
 {
 	namespace Physics
 	{
+		//hinge joint block prepared once per step: 3 point rows, 2 axis rows and the motor row
+		struct HingeJointRow
+		{
+			sRigidBodyState* pA;
+			sRigidBodyState* pB;
+			Matrix<float, 5, 12, RowMajor | DontAlign> J;
+			Matrix<float, 12, 5, DontAlign> impulseResponse;//M^-1 * J^T, zero for static bodies
+			Matrix<float, 5, 5, DontAlign> inverseK;//cached factorization of J * M^-1 * J^T
+			Matrix<float, 5, 1, DontAlign> bias;
+			bool motorEnable;
+			Math::sVector motorAxis;
+			Math::sVector motorResponseA;//-I_A^-1 * axis, zero for static bodies
+			Math::sVector motorResponseB;
+			float motorInverseK;
+			float motorSpeed;
+		};
+		void SolveHingeJointRow(HingeJointRow& io_row, SolverResidual& io_residual);
+
 		class HingeJoint
 		{
 		public:
@@ -45,7 +64,8 @@ namespace sca2025
 			float w_motor_B2A = 0.0f;
 			bool motorEnable = false;
 
-			void ResolveHingJoint(float i_dt);
+			void PrepareRow(float i_dt, HingeJointRow& o_row);
+			void ResolveHingJoint(float i_dt, SolverResidual& io_residual);
 		};
 
 		void HingeJointsSolver(float i_dt);
@@ -0,0 +1,345 @@
+#include <unordered_map>
+#include <cstdint>
+
+#include "Island.h"
+#include "PhysicsSimulation.h"
+#include "CollisionResolver.h"
+#include "ContactSolverSIMD.h"
+#include "Engine/GameCommon/GameObject.h"
+
+#define ISLAND_MAX_COLORS 64//one bit per color in the body color masks
+
+namespace sca2025 {
+	namespace Physics {
+		std::vector<ConstraintIsland> allIslands;
+		int islandColoringThreshold = 64;
+		int solverMinIterations = 4;
+		int solverMaxIterations = constraintMaxNum;
+		float solverImpulseTolerance = 1.0e-4f;
+		float solverVelocityTolerance = 1.0e-3f;
+		SolverMetrics solverMetrics;
+		int sleepTickWindow = 0;
+		float sleepLinearVelocity = 0.05f;
+		float sleepAngularVelocity = 0.05f;
+
+		namespace {
+			//union find over the dynamic bodies referenced by constraints
+			std::unordered_map<sRigidBodyState*, int> bodyIndices;
+			std::vector<sRigidBodyState*> bodies;
+			std::vector<int> parents;
+			std::vector<uint64_t> colorMasks;
+
+			int AddBody(sRigidBodyState* i_body)
+			{
+				if (i_body->isStatic) return -1;
+				auto it = bodyIndices.find(i_body);
+				if (it != bodyIndices.end()) return it->second;
+				int index = static_cast<int>(bodies.size());
+				bodyIndices[i_body] = index;
+				bodies.push_back(i_body);
+				parents.push_back(index);
+				return index;
+			}
+
+			int Find(int i)
+			{
+				while (parents[i] != i)
+				{
+					parents[i] = parents[parents[i]];
+					i = parents[i];
+				}
+				return i;
+			}
+
+			void GetBodies(const SolverConstraint& i_constraint, sRigidBodyState*& o_A, sRigidBodyState*& o_B)
+			{
+				switch (i_constraint.type)
+				{
+				case ContactConstraint:
+					o_A = allManifolds[i_constraint.index].colliderA->m_pParentRigidBody;
+					o_B = allManifolds[i_constraint.index].colliderB->m_pParentRigidBody;
+					break;
+				case PointJointConstraint:
+					o_A = &allPointJoints[i_constraint.index].pGameObject->m_State;
+					o_B = &allPointJoints[i_constraint.index].pParentObject->m_State;
+					break;
+				case HingeJointConstraint:
+					o_A = &allHingeJoints[i_constraint.index].pActorA->m_State;
+					o_B = &allHingeJoints[i_constraint.index].pActorB->m_State;
+					break;
+				}
+			}
+
+			void SolveConstraint(const SolverConstraint& i_constraint, float i_dt, int k, bool i_relax, SolverResidual& io_residual)
+			{
+				if (i_relax && i_constraint.type != ContactConstraint) return;
+				switch (i_constraint.type)
+				{
+				case ContactConstraint:
+					ResolveManifold(allManifolds[i_constraint.index], i_dt, k, i_relax, io_residual);
+					break;
+				case PointJointConstraint:
+					SolvePointJointRow(pointJointRows[i_constraint.index], io_residual);
+					break;
+				case HingeJointConstraint:
+					SolveHingeJointRow(hingeJointRows[i_constraint.index], io_residual);
+					break;
+				}
+			}
+
+			//anchors, jacobians and effective masses stay fixed while the solver iterates
+			void PrepareJointRows(float i_dt)
+			{
+				pointJointRows.resize(allPointJoints.size());
+				hingeJointRows.resize(allHingeJoints.size());
+				int numPointJoints = static_cast<int>(allPointJoints.size());
+				int numHingeJoints = static_cast<int>(allHingeJoints.size());
+#pragma omp parallel for
+				for (int i = 0; i < numPointJoints; i++) allPointJoints[i].PrepareRow(i_dt, pointJointRows[i]);
+#pragma omp parallel for
+				for (int i = 0; i < numHingeJoints; i++) allHingeJoints[i].PrepareRow(i_dt, hingeJointRows[i]);
+			}
+
+			void FallAsleep(sRigidBodyState& io_body)
+			{
+				io_body.isSleeping = true;
+				io_body.velocity = Math::sVector(0.0f, 0.0f, 0.0f);
+				io_body.angularVelocity = Math::sVector(0.0f, 0.0f, 0.0f);
+			}
+
+			bool IsConverged(const SolverResidual& i_residual, int i_iterations)
+			{
+				return i_iterations >= solverMinIterations && i_residual.impulse <= solverImpulseTolerance && i_residual.velocity <= solverVelocityTolerance;
+			}
+
+			//greedy coloring, a color never touches the same dynamic body twice so its constraints can run concurrently
+			void ColorIsland(ConstraintIsland& io_island)
+			{
+				io_island.colors.clear();
+				for (size_t i = 0; i < io_island.bodies.size(); i++)
+				{
+					colorMasks[bodyIndices[io_island.bodies[i]]] = 0;
+				}
+				std::vector<SolverConstraint> overflow;
+				for (size_t i = 0; i < io_island.constraints.size(); i++)
+				{
+					sRigidBodyState* pA;
+					sRigidBodyState* pB;
+					GetBodies(io_island.constraints[i], pA, pB);
+					int indexA = pA->isStatic ? -1 : bodyIndices[pA];
+					int indexB = pB->isStatic ? -1 : bodyIndices[pB];
+					uint64_t used = (indexA >= 0 ? colorMasks[indexA] : 0) | (indexB >= 0 ? colorMasks[indexB] : 0);
+					int color = 0;
+					while (color < ISLAND_MAX_COLORS && (used & (uint64_t(1) << color))) color++;
+					if (color == ISLAND_MAX_COLORS)
+					{
+						overflow.push_back(io_island.constraints[i]);
+						continue;
+					}
+					if (color >= static_cast<int>(io_island.colors.size())) io_island.colors.resize(color + 1);
+					io_island.colors[color].push_back(io_island.constraints[i]);
+					if (indexA >= 0) colorMasks[indexA] |= uint64_t(1) << color;
+					if (indexB >= 0) colorMasks[indexB] |= uint64_t(1) << color;
+				}
+				//constraints that did not fit into a color run serially as the last batch
+				if (!overflow.empty()) io_island.colors.push_back(overflow);
+			}
+		}
+
+		void BuildIslands()
+		{
+			bodyIndices.clear();
+			bodies.clear();
+			parents.clear();
+			allIslands.clear();
+
+			std::vector<SolverConstraint> constraints;
+			for (size_t i = 0; i < allManifolds.size(); i++) constraints.push_back({ ContactConstraint, static_cast<int>(i) });
+			for (size_t i = 0; i < allPointJoints.size(); i++) constraints.push_back({ PointJointConstraint, static_cast<int>(i) });
+			for (size_t i = 0; i < allHingeJoints.size(); i++) constraints.push_back({ HingeJointConstraint, static_cast<int>(i) });
+
+			//union the dynamic bodies of every constraint
+			std::vector<int> firstBody(constraints.size());
+			for (size_t i = 0; i < constraints.size(); i++)
+			{
+				sRigidBodyState* pA;
+				sRigidBodyState* pB;
+				GetBodies(constraints[i], pA, pB);
+				int indexA = AddBody(pA);
+				int indexB = AddBody(pB);
+				if (indexA >= 0 && indexB >= 0)
+				{
+					int rootA = Find(indexA);
+					int rootB = Find(indexB);
+					if (rootA != rootB) parents[rootA] = rootB;
+				}
+				firstBody[i] = indexA >= 0 ? indexA : indexB;
+			}
+			colorMasks.resize(bodies.size());
+
+			//one island per root, constraints keep the serial solver order
+			std::vector<int> islandOfRoot(bodies.size(), -1);
+			for (size_t i = 0; i < bodies.size(); i++)
+			{
+				int root = Find(static_cast<int>(i));
+				if (islandOfRoot[root] < 0)
+				{
+					islandOfRoot[root] = static_cast<int>(allIslands.size());
+					allIslands.push_back(ConstraintIsland());
+				}
+				allIslands[islandOfRoot[root]].bodies.push_back(bodies[i]);
+			}
+			for (size_t i = 0; i < constraints.size(); i++)
+			{
+				if (firstBody[i] < 0) continue;//both bodies are static
+				allIslands[islandOfRoot[Find(firstBody[i])]].constraints.push_back(constraints[i]);
+			}
+
+			//an island sleeps only as a whole, one awake body wakes the rest
+			for (size_t i = 0; i < allIslands.size(); i++)
+			{
+				ConstraintIsland& island = allIslands[i];
+				island.sleeping = true;
+				for (size_t b = 0; b < island.bodies.size() && island.sleeping; b++) island.sleeping = island.bodies[b]->isSleeping;
+				if (island.sleeping) continue;
+				for (size_t b = 0; b < island.bodies.size(); b++)
+				{
+					if (island.bodies[b]->isSleeping) island.bodies[b]->WakeUp();
+				}
+			}
+		}
+
+		void SolveIslands(float i_dt, int i_maxIterations, bool i_relax)
+		{
+			//the relax sweep skips joints
+			if (!i_relax) PrepareJointRows(i_dt);
+			std::vector<int> smallIslands, largeIslands;
+			for (size_t i = 0; i < allIslands.size(); i++)
+			{
+				if (allIslands[i].sleeping) continue;
+				if (static_cast<int>(allIslands[i].constraints.size()) >= islandColoringThreshold) largeIslands.push_back(static_cast<int>(i));
+				else smallIslands.push_back(static_cast<int>(i));
+			}
+
+			//independent islands run concurrently
+			int numSmallIslands = static_cast<int>(smallIslands.size());
+#pragma omp parallel for schedule(dynamic)
+			for (int i = 0; i < numSmallIslands; i++)
+			{
+				ConstraintIsland& island = allIslands[smallIslands[i]];
+				ContactRowsSoA contactRows;
+				if (simdContactSolver) BuildContactRows(island.constraints, false, i_dt, i_relax, contactRows);
+				for (int k = 0; k < i_maxIterations; k++)
+				{
+					SolverResidual residual;
+					if (simdContactSolver) SolveContactRows(contactRows, 0, residual);
+					for (size_t c = 0; c < island.constraints.size(); c++)
+					{
+						if (simdContactSolver && island.constraints[c].type == ContactConstraint) continue;
+						SolveConstraint(island.constraints[c], i_dt, k, i_relax, residual);
+					}
+					island.iterations++;
+					island.residual = residual;
+					if (IsConverged(residual, k + 1)) break;
+				}
+				if (simdContactSolver) FinishContactRows(contactRows);
+			}
+
+			//large islands run their colors concurrently
+			std::vector<SolverResidual> batchResiduals;
+			for (size_t i = 0; i < largeIslands.size(); i++)
+			{
+				ConstraintIsland& island = allIslands[largeIslands[i]];
+				//colors stay valid across the substeps of a step
+				if (island.colors.empty()) ColorIsland(island);
+				std::vector<ContactRowsSoA> colorRows(island.colors.size());
+				if (simdContactSolver)
+				{
+					for (size_t color = 0; color < island.colors.size(); color++)
+					{
+						BuildContactRows(island.colors[color], color != ISLAND_MAX_COLORS, i_dt, i_relax, colorRows[color]);
+					}
+				}
+				for (int k = 0; k < i_maxIterations; k++)
+				{
+					SolverResidual residual;
+					for (size_t color = 0; color < island.colors.size(); color++)
+					{
+						std::vector<SolverConstraint>& batch = island.colors[color];
+						int batchSize = static_cast<int>(batch.size());
+						bool overflowBatch = color == ISLAND_MAX_COLORS;
+						//one residual slot per parallel item, merged after the loop
+						if (simdContactSolver)
+						{
+							//groups of SIMD batches are independent inside a color
+							int numGroups = static_cast<int>(colorRows[color].groupStart.size()) - 1;
+							batchResiduals.assign(numGroups, SolverResidual());
+#pragma omp parallel for if(!overflowBatch)
+							for (int group = 0; group < numGroups; group++)
+							{
+								SolveContactRows(colorRows[color], group, batchResiduals[group]);
+							}
+							for (int group = 0; group < numGroups; group++) residual.Add(batchResiduals[group]);
+						}
+						batchResiduals.assign(batchSize, SolverResidual());
+#pragma omp parallel for if(!overflowBatch)
+						for (int c = 0; c < batchSize; c++)
+						{
+							if (simdContactSolver && batch[c].type == ContactConstraint) continue;
+							SolveConstraint(batch[c], i_dt, k, i_relax, batchResiduals[c]);
+						}
+						for (int c = 0; c < batchSize; c++) residual.Add(batchResiduals[c]);
+					}
+					island.iterations++;
+					island.residual = residual;
+					if (IsConverged(residual, k + 1)) break;
+				}
+				if (simdContactSolver)
+				{
+					for (size_t color = 0; color < colorRows.size(); color++) FinishContactRows(colorRows[color]);
+				}
+			}
+
+			solverMetrics = SolverMetrics();
+			solverMetrics.numIslands = static_cast<int>(allIslands.size());
+			for (size_t i = 0; i < allIslands.size(); i++)
+			{
+				if (allIslands[i].sleeping) solverMetrics.numSleepingIslands++;
+				solverMetrics.totalIterations += allIslands[i].iterations;
+				solverMetrics.maxIterations = std::max(solverMetrics.maxIterations, allIslands[i].iterations);
+				solverMetrics.residual.Add(allIslands[i].residual);
+			}
+		}
+
+		void UpdateSleepState(std::vector<GameCommon::GameObject *> & i_colliderObjects)
+		{
+			if (sleepTickWindow <= 0) return;
+			for (size_t i = 0; i < i_colliderObjects.size(); i++)
+			{
+				sRigidBodyState& state = i_colliderObjects[i]->m_State;
+				if (state.isStatic || state.isSleeping) continue;
+				if (state.velocity.GetLength() < sleepLinearVelocity && state.angularVelocity.GetLength() < sleepAngularVelocity) state.quietTickCount++;
+				else state.quietTickCount = 0;
+			}
+
+			//islands fall asleep once all of their bodies are quiet
+			for (size_t i = 0; i < allIslands.size(); i++)
+			{
+				ConstraintIsland& island = allIslands[i];
+				if (island.sleeping) continue;
+				bool quiet = true;
+				for (size_t b = 0; b < island.bodies.size() && quiet; b++) quiet = island.bodies[b]->quietTickCount >= sleepTickWindow;
+				if (!quiet) continue;
+				for (size_t b = 0; b < island.bodies.size(); b++) FallAsleep(*island.bodies[b]);
+			}
+
+			//bodies without constraints sleep on their own
+			for (size_t i = 0; i < i_colliderObjects.size(); i++)
+			{
+				sRigidBodyState& state = i_colliderObjects[i]->m_State;
+				if (state.isStatic || state.isSleeping || state.quietTickCount < sleepTickWindow) continue;
+				if (bodyIndices.find(&state) == bodyIndices.end()) FallAsleep(state);
+			}
+		}
+	}
+}
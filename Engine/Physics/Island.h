@@ -0,0 +1,66 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+
+namespace sca2025 {
+	namespace GameCommon {
+		class GameObject;
+	}
+
+	namespace Physics {
+		struct sRigidBodyState;
+
+		enum ConstraintType { ContactConstraint, PointJointConstraint, HingeJointConstraint };
+
+		//index into allManifolds, allPointJoints or allHingeJoints
+		struct SolverConstraint {
+			ConstraintType type;
+			int index;
+		};
+
+		//largest impulse change and velocity correction of one solver sweep
+		struct SolverResidual {
+			float impulse = 0.0f;
+			float velocity = 0.0f;
+			void Add(float i_impulse, float i_velocity) { impulse = std::max(impulse, i_impulse); velocity = std::max(velocity, i_velocity); }
+			void Add(const SolverResidual& i_other) { Add(i_other.impulse, i_other.velocity); }
+		};
+
+		//bodies connected through contacts or joints, static bodies do not connect islands
+		struct ConstraintIsland {
+			std::vector<sRigidBodyState*> bodies;
+			std::vector<SolverConstraint> constraints;//contacts first, then point joints, then hinge joints, the order of the serial solver
+			std::vector<std::vector<SolverConstraint>> colors;//batches without shared dynamic bodies, only built for large islands
+			bool sleeping = false;//every body is asleep, the solver skips the island
+			int iterations = 0;//sweeps run in this step
+			SolverResidual residual;//residual of the last sweep
+		};
+
+		//per step totals over all islands
+		struct SolverMetrics {
+			int numIslands = 0;
+			int numSleepingIslands = 0;
+			int totalIterations = 0;
+			int maxIterations = 0;
+			SolverResidual residual;//worst final residual
+		};
+
+		extern std::vector<ConstraintIsland> allIslands;
+		extern int islandColoringThreshold;//islands with at least this many constraints are solved in parallel colored batches
+		//an island stops iterating once a sweep stays under both tolerances, after at least solverMinIterations sweeps
+		extern int solverMinIterations;
+		extern int solverMaxIterations;
+		extern float solverImpulseTolerance;
+		extern float solverVelocityTolerance;
+		extern SolverMetrics solverMetrics;
+		//bodies under both velocities for sleepTickWindow steps fall asleep together with their island, 0 disables sleeping (default), scenes opt in
+		extern int sleepTickWindow;
+		extern float sleepLinearVelocity;
+		extern float sleepAngularVelocity;
+
+		void BuildIslands();
+		//i_relax runs without warm starting, penetration bias and joints, the relax sweep of a substep
+		void SolveIslands(float i_dt, int i_maxIterations, bool i_relax);
+		void UpdateSleepState(std::vector<GameCommon::GameObject *> & i_colliderObjects);
+	}
+}
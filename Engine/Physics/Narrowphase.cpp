@@ -0,0 +1,579 @@
+#include <cmath>
+#include <algorithm>
+
+#include "Narrowphase.h"
+#include "Engine/Math/3DMathHelpers.h"
+
+//feature ids of analytic contacts, 0 is reserved for "no feature"
+#define FEATURE_SINGLE_CONTACT 1
+#define FEATURE_BOX_FACE_BASE 2
+#define FEATURE_BOX_EDGE_BASE 4096
+#define FEATURE_MESH_BASE 65536
+
+#define MESH_MAX_CANDIDATES 64
+
+namespace sca2025 {
+	namespace Physics {
+		namespace {
+			struct BoxData {
+				Math::sVector center;
+				Math::sVector axis[3];
+				float extents[3];
+			};
+
+			float Component(const Math::sVector& i_v, int i_axis)
+			{
+				if (i_axis == 0) return i_v.x;
+				if (i_axis == 1) return i_v.y;
+				return i_v.z;
+			}
+
+			Math::sVector Column(const Math::cMatrix_transformation& i_m, int i_axis)
+			{
+				if (i_axis == 0) return Math::sVector(i_m.m_00, i_m.m_10, i_m.m_20);
+				if (i_axis == 1) return Math::sVector(i_m.m_01, i_m.m_11, i_m.m_21);
+				return Math::sVector(i_m.m_02, i_m.m_12, i_m.m_22);
+			}
+
+			Math::sVector WorldToLocal(const Math::cMatrix_transformation& i_m, const Math::sVector& i_p)
+			{
+				Math::sVector d = i_p - i_m.GetTranslation();
+				return Math::sVector(Math::Dot(Column(i_m, 0), d), Math::Dot(Column(i_m, 1), d), Math::Dot(Column(i_m, 2), d));
+			}
+
+			Math::sVector LocalDirToWorld(const Math::cMatrix_transformation& i_m, const Math::sVector& i_d)
+			{
+				return Column(i_m, 0) * i_d.x + Column(i_m, 1) * i_d.y + Column(i_m, 2) * i_d.z;
+			}
+
+			//box colliders are centered at the local origin, half extents come from the local box of the hull
+			BoxData GetBoxData(Collider& i_box)
+			{
+				BoxData box;
+				box.center = i_box.m_transformation.GetTranslation();
+				for (int k = 0; k < 3; k++)
+				{
+					box.axis[k] = Column(i_box.m_transformation, k);
+					box.extents[k] = 0.0f;
+				}
+				if (!i_box.m_hull->vertices.empty())
+				{
+					const ConvexHull& hull = *i_box.m_hull;
+					box.extents[0] = std::abs(hull.boxCenter.x) + hull.boxExtends.x;
+					box.extents[1] = std::abs(hull.boxCenter.y) + hull.boxExtends.y;
+					box.extents[2] = std::abs(hull.boxCenter.z) + hull.boxExtends.z;
+				}
+				return box;
+			}
+
+			float ProjectedRadius(const BoxData& i_box, const Math::sVector& i_axis)
+			{
+				return i_box.extents[0] * std::abs(Math::Dot(i_box.axis[0], i_axis))
+					+ i_box.extents[1] * std::abs(Math::Dot(i_box.axis[1], i_axis))
+					+ i_box.extents[2] * std::abs(Math::Dot(i_box.axis[2], i_axis));
+			}
+
+			void SetContact(Contact& o_contact, Collider& i_A, Collider& i_B, const Math::sVector& i_positionA, const Math::sVector& i_positionB, const Math::sVector& i_normal, unsigned int i_featureId)
+			{
+				o_contact = Contact();
+				o_contact.globalPositionA = i_positionA;
+				o_contact.globalPositionB = i_positionB;
+				o_contact.localPositionA = WorldToLocal(i_A.m_transformation, i_positionA);
+				o_contact.localPositionB = WorldToLocal(i_B.m_transformation, i_positionB);
+				o_contact.normal = i_normal;
+				o_contact.depth = Math::Dot(i_positionA - i_positionB, i_normal);
+				o_contact.tangent1 = Math::GetTangentVector(i_normal);
+				o_contact.tangent1.Normalize();
+				o_contact.tangent2 = Math::Cross(i_normal, o_contact.tangent1).GetNormalized();
+				o_contact.colliderA = &i_A;
+				o_contact.colliderB = &i_B;
+				o_contact.featureId = i_featureId;
+			}
+
+			HalfSpace GetHalfSpace(Collider& i_plane)
+			{
+				HalfSpace halfSpace;
+				halfSpace.normal = LocalDirToWorld(i_plane.m_transformation, i_plane.m_hull->vertices[1]).GetNormalized();
+				halfSpace.offset = Math::Dot(halfSpace.normal, i_plane.m_transformation * i_plane.m_hull->vertices[0]);
+				return halfSpace;
+			}
+
+			//swaps A and B of contacts generated with the colliders in the other order
+			int FlipContacts(Contact* io_contacts, int i_count)
+			{
+				for (int i = 0; i < i_count; i++)
+				{
+					Contact& c = io_contacts[i];
+					std::swap(c.globalPositionA, c.globalPositionB);
+					std::swap(c.localPositionA, c.localPositionB);
+					std::swap(c.colliderA, c.colliderB);
+					c.normal = -c.normal;
+					c.tangent1 = Math::GetTangentVector(c.normal);
+					c.tangent1.Normalize();
+					c.tangent2 = Math::Cross(c.normal, c.tangent1).GetNormalized();
+				}
+				return i_count;
+			}
+
+			//keeps the deepest contact and the three that span the largest area
+			int ReduceContacts(Contact* io_contacts, int i_count)
+			{
+				if (i_count <= 4) return i_count;
+				int selected[4];
+				selected[0] = 0;
+				for (int i = 1; i < i_count; i++)
+				{
+					if (io_contacts[i].depth > io_contacts[selected[0]].depth) selected[0] = i;
+				}
+				Math::sVector a = io_contacts[selected[0]].globalPositionA;
+
+				float best = -1.0f;
+				selected[1] = selected[0];
+				for (int i = 0; i < i_count; i++)
+				{
+					float distSQ = (io_contacts[i].globalPositionA - a).GetLengthSQ();
+					if (distSQ > best) { best = distSQ; selected[1] = i; }
+				}
+				Math::sVector b = io_contacts[selected[1]].globalPositionA;
+
+				best = -1.0f;
+				selected[2] = selected[0];
+				for (int i = 0; i < i_count; i++)
+				{
+					float areaSQ = Math::Cross(b - a, io_contacts[i].globalPositionA - a).GetLengthSQ();
+					if (areaSQ > best) { best = areaSQ; selected[2] = i; }
+				}
+				Math::sVector c = io_contacts[selected[2]].globalPositionA;
+
+				best = -1.0f;
+				selected[3] = selected[0];
+				for (int i = 0; i < i_count; i++)
+				{
+					if (i == selected[0] || i == selected[1] || i == selected[2]) continue;
+					Math::sVector p = io_contacts[i].globalPositionA;
+					float distSQ = Math::SqDistPointTriangle(p, a, b, c);
+					if (distSQ > best) { best = distSQ; selected[3] = i; }
+				}
+
+				Contact reduced[4];
+				for (int k = 0; k < 4; k++) reduced[k] = io_contacts[selected[k]];
+				for (int k = 0; k < 4; k++) io_contacts[k] = reduced[k];
+				return 4;
+			}
+
+			//closest points of two segments given by center, unit direction and half length
+			void ClosestPointsOnSegments(const Math::sVector& i_centerA, const Math::sVector& i_dirA, float i_halfA,
+				const Math::sVector& i_centerB, const Math::sVector& i_dirB, float i_halfB, Math::sVector& o_pointA, Math::sVector& o_pointB)
+			{
+				Math::sVector r = i_centerA - i_centerB;
+				float b = Math::Dot(i_dirA, i_dirB);
+				float dA = Math::Dot(i_dirA, r);
+				float dB = Math::Dot(i_dirB, r);
+				float denom = 1.0f - b * b;
+				float s = denom > 1.0e-6f ? (b * dB - dA) / denom : 0.0f;
+				s = std::max(-i_halfA, std::min(i_halfA, s));
+				float t = std::max(-i_halfB, std::min(i_halfB, dB + s * b));
+				s = std::max(-i_halfA, std::min(i_halfA, t * b - dA));
+				o_pointA = i_centerA + i_dirA * s;
+				o_pointB = i_centerB + i_dirB * t;
+			}
+
+			struct ClipVertex {
+				Math::sVector position;
+				int tag;
+			};
+
+			//Sutherland-Hodgman against the plane Dot(n, x) <= d
+			int ClipPolygon(const ClipVertex* i_in, int i_count, const Math::sVector& i_n, float i_d, int i_planeIndex, ClipVertex* o_out)
+			{
+				int outCount = 0;
+				for (int i = 0; i < i_count; i++)
+				{
+					const ClipVertex& v0 = i_in[i];
+					const ClipVertex& v1 = i_in[(i + 1) % i_count];
+					float d0 = Math::Dot(i_n, v0.position) - i_d;
+					float d1 = Math::Dot(i_n, v1.position) - i_d;
+					if (d0 <= 0.0f) o_out[outCount++] = v0;
+					if ((d0 < 0.0f && d1 > 0.0f) || (d0 > 0.0f && d1 < 0.0f))
+					{
+						ClipVertex intersection;
+						intersection.position = v0.position + (v1.position - v0.position) * (d0 / (d0 - d1));
+						intersection.tag = 4 + i_planeIndex * 4 + (v0.tag & 3);
+						o_out[outCount++] = intersection;
+					}
+				}
+				return outCount;
+			}
+		}
+
+		int Collide(Collider& i_A, Collider& i_B, Contact* o_contacts, bool& o_fullManifold, Math::sVector& io_searchDir)
+		{
+			o_fullManifold = true;
+			ColliderType typeA = i_A.m_type;
+			ColliderType typeB = i_B.m_type;
+			if (typeA == Box && typeB == Box) return CollideBoxBox(i_A, i_B, o_contacts);
+			if (typeA == Sphere && typeB == Sphere) return CollideSphereSphere(i_A, i_B, o_contacts);
+			if (typeA == Sphere && typeB == Box) return CollideSphereBox(i_A, i_B, o_contacts);
+			if (typeA == Box && typeB == Sphere) return FlipContacts(o_contacts, CollideSphereBox(i_B, i_A, o_contacts));
+			if (typeA == Box && typeB == Plane) return CollideBoxPlane(i_A, i_B, o_contacts);
+			if (typeA == Plane && typeB == Box) return FlipContacts(o_contacts, CollideBoxPlane(i_B, i_A, o_contacts));
+			if (typeA == Sphere && typeB == Plane) return CollideSpherePlane(i_A, i_B, o_contacts);
+			if (typeA == Plane && typeB == Sphere) return FlipContacts(o_contacts, CollideSpherePlane(i_B, i_A, o_contacts));
+			if (typeA == Plane || typeB == Plane) return 0;
+			if (typeB == TriMesh && typeA != TriMesh) return CollideConvexMesh(i_A, i_B, o_contacts);
+			if (typeA == TriMesh && typeB != TriMesh) return FlipContacts(o_contacts, CollideConvexMesh(i_B, i_A, o_contacts));
+			if (typeA == TriMesh || typeB == TriMesh) return 0;
+
+			//generic convex pair
+			o_fullManifold = false;
+			return i_A.IsCollided(i_B, o_contacts[0], io_searchDir) ? 1 : 0;
+		}
+
+		int CollideSphereSphere(Collider& i_A, Collider& i_B, Contact* o_contacts)
+		{
+			Math::sVector centerA = i_A.m_transformation * i_A.m_hull->vertices[0];
+			Math::sVector centerB = i_B.m_transformation * i_B.m_hull->vertices[0];
+			float rA = i_A.m_hull->vertices[1].GetLength();
+			float rB = i_B.m_hull->vertices[1].GetLength();
+			Math::sVector d = centerB - centerA;
+			float distSQ = d.GetLengthSQ();
+			if (distSQ > (rA + rB) * (rA + rB)) return 0;
+
+			float dist = std::sqrt(distSQ);
+			Math::sVector normal = dist > 1.0e-6f ? d / dist : Math::sVector(0.0f, 1.0f, 0.0f);
+			SetContact(o_contacts[0], i_A, i_B, centerA + normal * rA, centerB - normal * rB, normal, FEATURE_SINGLE_CONTACT);
+			return 1;
+		}
+
+		int CollideSphereBox(Collider& i_sphere, Collider& i_box, Contact* o_contacts)
+		{
+			BoxData box = GetBoxData(i_box);
+			Math::sVector center = i_sphere.m_transformation * i_sphere.m_hull->vertices[0];
+			float r = i_sphere.m_hull->vertices[1].GetLength();
+
+			//sphere center in box space
+			Math::sVector d = center - box.center;
+			float q[3], closest[3];
+			bool inside = true;
+			for (int k = 0; k < 3; k++)
+			{
+				q[k] = Math::Dot(d, box.axis[k]);
+				closest[k] = std::max(-box.extents[k], std::min(box.extents[k], q[k]));
+				if (closest[k] != q[k]) inside = false;
+			}
+
+			Math::sVector normal;//from sphere to box
+			Math::sVector pointOnBox;
+			if (!inside)
+			{
+				pointOnBox = box.center + box.axis[0] * closest[0] + box.axis[1] * closest[1] + box.axis[2] * closest[2];
+				Math::sVector delta = center - pointOnBox;
+				float distSQ = delta.GetLengthSQ();
+				if (distSQ > r * r) return 0;
+				normal = -delta / std::sqrt(distSQ);
+			}
+			else
+			{
+				//push out through the nearest face
+				int face = 0;
+				float minDepth = box.extents[0] - std::abs(q[0]);
+				for (int k = 1; k < 3; k++)
+				{
+					float faceDepth = box.extents[k] - std::abs(q[k]);
+					if (faceDepth < minDepth) { minDepth = faceDepth; face = k; }
+				}
+				float sign = q[face] >= 0.0f ? 1.0f : -1.0f;
+				closest[face] = box.extents[face] * sign;
+				pointOnBox = box.center + box.axis[0] * closest[0] + box.axis[1] * closest[1] + box.axis[2] * closest[2];
+				normal = -box.axis[face] * sign;
+			}
+			SetContact(o_contacts[0], i_sphere, i_box, center + normal * r, pointOnBox, normal, FEATURE_SINGLE_CONTACT);
+			return 1;
+		}
+
+		int CollideBoxBox(Collider& i_A, Collider& i_B, Contact* o_contacts)
+		{
+			BoxData boxA = GetBoxData(i_A);
+			BoxData boxB = GetBoxData(i_B);
+			Math::sVector T = boxB.center - boxA.center;
+
+			//face axes of A and B
+			float bestFaceA = -FLT_MAX, bestFaceB = -FLT_MAX, bestEdge = -FLT_MAX;
+			int faceA = 0, faceB = 0, edgeA = 0, edgeB = 0;
+			for (int k = 0; k < 3; k++)
+			{
+				float s = std::abs(Math::Dot(T, boxA.axis[k])) - boxA.extents[k] - ProjectedRadius(boxB, boxA.axis[k]);
+				if (s > 0.0f) return 0;
+				if (s > bestFaceA) { bestFaceA = s; faceA = k; }
+
+				s = std::abs(Math::Dot(T, boxB.axis[k])) - boxB.extents[k] - ProjectedRadius(boxA, boxB.axis[k]);
+				if (s > 0.0f) return 0;
+				if (s > bestFaceB) { bestFaceB = s; faceB = k; }
+			}
+			//edge axes
+			Math::sVector edgeAxis;
+			for (int i = 0; i < 3; i++)
+			{
+				for (int j = 0; j < 3; j++)
+				{
+					Math::sVector L = Math::Cross(boxA.axis[i], boxB.axis[j]);
+					float length = L.GetLength();
+					if (length < 1.0e-5f) continue;//parallel edges, covered by the face axes
+					L /= length;
+					float s = std::abs(Math::Dot(T, L)) - ProjectedRadius(boxA, L) - ProjectedRadius(boxB, L);
+					if (s > 0.0f) return 0;
+					if (s > bestEdge) { bestEdge = s; edgeA = i; edgeB = j; edgeAxis = L; }
+				}
+			}
+
+			//prefer face contacts, they give stable manifolds
+			const float relativeTolerance = 0.95f;
+			const float absoluteTolerance = 0.01f;
+			bool referenceIsA = true;
+			float bestFace = bestFaceA;
+			if (bestFaceB > relativeTolerance * bestFaceA + absoluteTolerance)
+			{
+				referenceIsA = false;
+				bestFace = bestFaceB;
+			}
+
+			if (bestEdge > relativeTolerance * bestFace + absoluteTolerance)
+			{
+				Math::sVector normal = Math::Dot(edgeAxis, T) < 0.0f ? -edgeAxis : edgeAxis;
+				//support edges of both boxes
+				Math::sVector edgeCenterA = boxA.center;
+				Math::sVector edgeCenterB = boxB.center;
+				for (int k = 0; k < 3; k++)
+				{
+					if (k != edgeA) edgeCenterA += boxA.axis[k] * (Math::Dot(boxA.axis[k], normal) > 0.0f ? boxA.extents[k] : -boxA.extents[k]);
+					if (k != edgeB) edgeCenterB += boxB.axis[k] * (Math::Dot(boxB.axis[k], normal) < 0.0f ? boxB.extents[k] : -boxB.extents[k]);
+				}
+				Math::sVector pointA, pointB;
+				ClosestPointsOnSegments(edgeCenterA, boxA.axis[edgeA], boxA.extents[edgeA], edgeCenterB, boxB.axis[edgeB], boxB.extents[edgeB], pointA, pointB);
+				SetContact(o_contacts[0], i_A, i_B, pointA, pointB, normal, FEATURE_BOX_EDGE_BASE + edgeA * 3 + edgeB);
+				return 1;
+			}
+
+			//face contact, clip the incident face against the side planes of the reference face
+			const BoxData& reference = referenceIsA ? boxA : boxB;
+			const BoxData& incident = referenceIsA ? boxB : boxA;
+			int referenceAxis = referenceIsA ? faceA : faceB;
+			Math::sVector towardsIncident = referenceIsA ? T : -T;
+			float referenceSign = Math::Dot(reference.axis[referenceAxis], towardsIncident) >= 0.0f ? 1.0f : -1.0f;
+			Math::sVector referenceNormal = reference.axis[referenceAxis] * referenceSign;
+			Math::sVector referenceFaceCenter = reference.center + referenceNormal * reference.extents[referenceAxis];
+
+			int incidentAxis = 0;
+			float maxAlignment = -1.0f;
+			for (int k = 0; k < 3; k++)
+			{
+				float alignment = std::abs(Math::Dot(incident.axis[k], referenceNormal));
+				if (alignment > maxAlignment) { maxAlignment = alignment; incidentAxis = k; }
+			}
+			float incidentSign = Math::Dot(incident.axis[incidentAxis], referenceNormal) > 0.0f ? -1.0f : 1.0f;
+			Math::sVector incidentFaceCenter = incident.center + incident.axis[incidentAxis] * (incident.extents[incidentAxis] * incidentSign);
+			int p = (incidentAxis + 1) % 3;
+			int q = (incidentAxis + 2) % 3;
+			Math::sVector u = incident.axis[p] * incident.extents[p];
+			Math::sVector v = incident.axis[q] * incident.extents[q];
+
+			ClipVertex polygon[NARROWPHASE_MAX_CONTACTS], clipped[NARROWPHASE_MAX_CONTACTS];
+			polygon[0].position = incidentFaceCenter + u + v; polygon[0].tag = 0;
+			polygon[1].position = incidentFaceCenter - u + v; polygon[1].tag = 1;
+			polygon[2].position = incidentFaceCenter - u - v; polygon[2].tag = 2;
+			polygon[3].position = incidentFaceCenter + u - v; polygon[3].tag = 3;
+			int count = 4;
+			int planeIndex = 0;
+			for (int k = 0; k < 3 && count > 0; k++)
+			{
+				if (k == referenceAxis) continue;
+				Math::sVector side = reference.axis[k];
+				float offset = Math::Dot(side, reference.center);
+				count = ClipPolygon(polygon, count, side, offset + reference.extents[k], planeIndex++, clipped);
+				count = ClipPolygon(clipped, count, -side, -offset + reference.extents[k], planeIndex++, polygon);
+			}
+
+			unsigned int faceFeature = FEATURE_BOX_FACE_BASE
+				+ (((referenceIsA ? 0 : 6) + referenceAxis * 2 + (referenceSign > 0.0f ? 1 : 0)) * 6 + incidentAxis * 2 + (incidentSign > 0.0f ? 1 : 0)) * 32;
+			Math::sVector normal = referenceIsA ? referenceNormal : -referenceNormal;
+			int numContacts = 0;
+			for (int i = 0; i < count; i++)
+			{
+				float separation = Math::Dot(polygon[i].position - referenceFaceCenter, referenceNormal);
+				if (separation > 0.0f) continue;
+				Math::sVector onReference = polygon[i].position - referenceNormal * separation;
+				unsigned int featureId = faceFeature + static_cast<unsigned int>(polygon[i].tag);
+				if (referenceIsA) SetContact(o_contacts[numContacts], i_A, i_B, onReference, polygon[i].position, normal, featureId);
+				else SetContact(o_contacts[numContacts], i_A, i_B, polygon[i].position, onReference, normal, featureId);
+				numContacts++;
+			}
+			return ReduceContacts(o_contacts, numContacts);
+		}
+
+		int CollideBoxPlane(Collider& i_box, Collider& i_plane, Contact* o_contacts)
+		{
+			HalfSpace halfSpace = GetHalfSpace(i_plane);
+			BoxData box = GetBoxData(i_box);
+			HalfSpaceContact corners[8];
+			int numCorners = CollideBoxHalfSpace(box.center, box.axis, box.extents, halfSpace, corners);
+			int numContacts = std::min(numCorners, NARROWPHASE_MAX_CONTACTS);
+			for (int i = 0; i < numContacts; i++)
+			{
+				const HalfSpaceContact& corner = corners[i];
+				SetContact(o_contacts[i], i_box, i_plane, corner.position, corner.position + halfSpace.normal * corner.depth, -halfSpace.normal,
+					FEATURE_SINGLE_CONTACT + static_cast<unsigned int>(corner.feature));
+			}
+			return ReduceContacts(o_contacts, numContacts);
+		}
+
+		int CollideSpherePlane(Collider& i_sphere, Collider& i_plane, Contact* o_contacts)
+		{
+			HalfSpace halfSpace = GetHalfSpace(i_plane);
+			Math::sVector center = i_sphere.m_transformation * i_sphere.m_hull->vertices[0];
+			HalfSpaceContact contact;
+			if (CollideSphereHalfSpace(center, i_sphere.m_hull->vertices[1].GetLength(), halfSpace, &contact) == 0) return 0;
+			SetContact(o_contacts[0], i_sphere, i_plane, contact.position, contact.position + halfSpace.normal * contact.depth, -halfSpace.normal, FEATURE_SINGLE_CONTACT);
+			return 1;
+		}
+
+		int CollideBoxHalfSpace(const Math::sVector& i_center, const Math::sVector* i_axes, const float* i_extents, const HalfSpace& i_halfSpace, HalfSpaceContact* o_contacts)
+		{
+			//separation of corner k is the center separation plus the signed projections of the three half axes
+			float centerSeparation = Math::Dot(i_halfSpace.normal, i_center) - i_halfSpace.offset;
+			float projection[3];
+			for (int j = 0; j < 3; j++) projection[j] = i_extents[j] * Math::Dot(i_halfSpace.normal, i_axes[j]);
+			if (centerSeparation - std::abs(projection[0]) - std::abs(projection[1]) - std::abs(projection[2]) > 0.0f) return 0;
+
+			int numContacts = 0;
+			for (int k = 0; k < 8; k++)
+			{
+				float separation = centerSeparation;
+				Math::sVector corner = i_center;
+				for (int j = 0; j < 3; j++)
+				{
+					float sign = (k & (1 << j)) ? 1.0f : -1.0f;
+					separation += sign * projection[j];
+					corner += i_axes[j] * (sign * i_extents[j]);
+				}
+				if (separation > 0.0f) continue;
+				o_contacts[numContacts].position = corner;
+				o_contacts[numContacts].depth = -separation;
+				o_contacts[numContacts].feature = k;
+				numContacts++;
+			}
+			return numContacts;
+		}
+
+		int CollideSphereHalfSpace(const Math::sVector& i_center, float i_radius, const HalfSpace& i_halfSpace, HalfSpaceContact* o_contacts)
+		{
+			float separation = Math::Dot(i_halfSpace.normal, i_center) - i_halfSpace.offset - i_radius;
+			if (separation > 0.0f) return 0;
+			o_contacts[0].position = i_center - i_halfSpace.normal * i_radius;
+			o_contacts[0].depth = -separation;
+			o_contacts[0].feature = 0;
+			return 1;
+		}
+
+		int CollideConvexMesh(Collider& i_convex, Collider& i_mesh, Contact* o_contacts)
+		{
+			if (!i_mesh.m_mesh || (i_convex.m_type != Box && i_convex.m_type != Sphere)) return 0;
+			const TriangleMesh& mesh = *i_mesh.m_mesh;
+			const Math::cMatrix_transformation& meshTransform = i_mesh.m_transformation;
+
+			//bounding sphere of the convex collider, queried as a box in mesh space
+			BoxData box;
+			Math::sVector center;
+			float radius;
+			if (i_convex.m_type == Sphere)
+			{
+				center = i_convex.m_transformation * i_convex.m_hull->vertices[0];
+				radius = i_convex.m_hull->vertices[1].GetLength();
+			}
+			else
+			{
+				box = GetBoxData(i_convex);
+				center = box.center;
+				radius = Math::sVector(box.extents[0], box.extents[1], box.extents[2]).GetLength();
+			}
+			Math::sVector localCenter = WorldToLocal(meshTransform, center);
+			Math::sVector reach(radius, radius, radius);
+			//reused by every call on this thread
+			thread_local std::vector<int> triangles;
+			triangles.clear();
+			mesh.QueryBox(localCenter - reach, localCenter + reach, triangles);
+
+			Contact candidates[MESH_MAX_CANDIDATES];
+			int numCandidates = 0;
+			for (size_t t = 0; t < triangles.size() && numCandidates < MESH_MAX_CANDIDATES; t++)
+			{
+				int triangle = triangles[t];
+				Math::sVector a = meshTransform * mesh.vertices[mesh.indices[triangle * 3]];
+				Math::sVector b = meshTransform * mesh.vertices[mesh.indices[triangle * 3 + 1]];
+				Math::sVector c = meshTransform * mesh.vertices[mesh.indices[triangle * 3 + 2]];
+				Math::sVector faceNormal = LocalDirToWorld(meshTransform, mesh.normals[triangle]);
+				unsigned int featureBase = FEATURE_MESH_BASE + static_cast<unsigned int>(triangle) * 16;
+
+				//the convex must be in front of the triangle plane, two sided triangles face the convex
+				Math::sVector triangleNormal = faceNormal;
+				float centerSeparation = Math::Dot(triangleNormal, center - a);
+				if (centerSeparation < 0.0f && mesh.twoSided)
+				{
+					triangleNormal = -faceNormal;
+					centerSeparation = -centerSeparation;
+				}
+				if (centerSeparation < 0.0f || centerSeparation > radius) continue;
+
+				if (i_convex.m_type == Sphere)
+				{
+					Vector3d closest = Math::PointToTriangleDis(Vector3d(center.x, center.y, center.z),
+						Vector3d(a.x, a.y, a.z), Vector3d(b.x, b.y, b.z), Vector3d(c.x, c.y, c.z));
+					Math::sVector pointOnTriangle(static_cast<float>(closest.x()), static_cast<float>(closest.y()), static_cast<float>(closest.z()));
+					Math::sVector delta = pointOnTriangle - center;
+					float distSQ = delta.GetLengthSQ();
+					if (distSQ > radius * radius) continue;
+					float dist = std::sqrt(distSQ);
+					Math::sVector normal = dist > 1.0e-6f ? delta / dist : -triangleNormal;
+					SetContact(candidates[numCandidates++], i_convex, i_mesh, center + normal * radius, pointOnTriangle, normal, featureBase);
+					continue;
+				}
+
+				//box corners below the triangle plane and inside its prism, the box-plane test per triangle
+				Math::sVector edges[3] = { b - a, c - b, a - c };
+				Math::sVector corners[3] = { a, b, c };
+				for (int k = 0; k < 8 && numCandidates < MESH_MAX_CANDIDATES; k++)
+				{
+					Math::sVector corner = box.center
+						+ box.axis[0] * ((k & 1) ? box.extents[0] : -box.extents[0])
+						+ box.axis[1] * ((k & 2) ? box.extents[1] : -box.extents[1])
+						+ box.axis[2] * ((k & 4) ? box.extents[2] : -box.extents[2]);
+					float separation = Math::Dot(triangleNormal, corner - a);
+					if (separation > 0.0f) continue;
+					bool inside = true;
+					for (int e = 0; e < 3 && inside; e++)
+					{
+						if (Math::Dot(Math::Cross(edges[e], corner - corners[e]), faceNormal) < 0.0f) inside = false;
+					}
+					if (!inside) continue;
+					SetContact(candidates[numCandidates++], i_convex, i_mesh, corner, corner - triangleNormal * separation, -triangleNormal, featureBase + static_cast<unsigned int>(k));
+				}
+
+				//triangle vertices poking into the box
+				float boxBottom = Math::Dot(triangleNormal, box.center) - ProjectedRadius(box, triangleNormal);
+				for (int k = 0; k < 3 && numCandidates < MESH_MAX_CANDIDATES; k++)
+				{
+					Math::sVector d = corners[k] - box.center;
+					if (std::abs(Math::Dot(d, box.axis[0])) >= box.extents[0]
+						|| std::abs(Math::Dot(d, box.axis[1])) >= box.extents[1]
+						|| std::abs(Math::Dot(d, box.axis[2])) >= box.extents[2]) continue;
+					float depth = Math::Dot(triangleNormal, corners[k]) - boxBottom;
+					SetContact(candidates[numCandidates++], i_convex, i_mesh, corners[k] - triangleNormal * depth, corners[k], -triangleNormal, featureBase + 8 + static_cast<unsigned int>(k));
+				}
+			}
+
+			int count = ReduceContacts(candidates, numCandidates);
+			count = std::min(count, NARROWPHASE_MAX_CONTACTS);
+			for (int i = 0; i < count; i++) o_contacts[i] = candidates[i];
+			return count;
+		}
+	}
+}
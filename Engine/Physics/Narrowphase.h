@@ -0,0 +1,38 @@
+#pragma once
+#include "CollisionHelpers.h"
+
+#define NARROWPHASE_MAX_CONTACTS 8
+
+namespace sca2025 {
+	namespace Physics {
+		//points with Dot(normal, x) <= offset are inside, the ground of a scene
+		struct HalfSpace {
+			Math::sVector normal = Math::sVector(0.0f, 1.0f, 0.0f);
+			float offset = 0.0f;
+		};
+
+		//point of a shape below a half-space, the matching ground point is position + normal * depth
+		struct HalfSpaceContact {
+			Math::sVector position;
+			float depth;
+			int feature;//corner of a box, 0 for a sphere
+		};
+
+		//contact generation dispatched by collider type, o_contacts needs room for NARROWPHASE_MAX_CONTACTS
+		//analytic routines return a complete manifold (o_fullManifold), the GJK/EPA fallback returns a single contact to be merged
+		//normals point from A to B, the same convention as EPA
+		int Collide(Collider& i_A, Collider& i_B, Contact* o_contacts, bool& o_fullManifold, Math::sVector& io_searchDir);
+
+		int CollideSphereSphere(Collider& i_A, Collider& i_B, Contact* o_contacts);
+		int CollideSphereBox(Collider& i_sphere, Collider& i_box, Contact* o_contacts);
+		int CollideBoxBox(Collider& i_A, Collider& i_B, Contact* o_contacts);
+		int CollideBoxPlane(Collider& i_box, Collider& i_plane, Contact* o_contacts);
+		int CollideSpherePlane(Collider& i_sphere, Collider& i_plane, Contact* o_contacts);
+		//closed form shape against half-space tests, also used by shapes that are not colliders (multibody links)
+		//box corner k has the sign of axis j set when bit j of k is set, o_contacts needs room for 8
+		int CollideBoxHalfSpace(const Math::sVector& i_center, const Math::sVector* i_axes, const float* i_extents, const HalfSpace& i_halfSpace, HalfSpaceContact* o_contacts);
+		int CollideSphereHalfSpace(const Math::sVector& i_center, float i_radius, const HalfSpace& i_halfSpace, HalfSpaceContact* o_contacts);
+		//box or sphere against the triangles of a static mesh found through its BVH
+		int CollideConvexMesh(Collider& i_convex, Collider& i_mesh, Contact* o_contacts);
+	}
+}
@@ -8,6 +8,10 @@
 #include "Engine/UserOutput/UserOutput.h"
 #include "CollisionResolver.h"
 #include "Engine/Physics/HingeJoint.h"
+#include "Broadphase.h"
+#include "Narrowphase.h"
+#include "Island.h"
+#include "WorldQuery.h"
 
 namespace sca2025 {
 	namespace Physics {
@@ -18,16 +22,109 @@ namespace sca2025 {
 		bool simPlay = false;
 
 		std::vector<ContactManifold3D> allManifolds;
+		std::unordered_map<ColliderPairKey, size_t, ColliderPairKeyHash> manifoldCache;
+		std::unordered_map<ColliderPairKey, GJKCacheEntry, ColliderPairKeyHash> gjkCache;
+		unsigned int narrowphaseFrame = 0;
+		int solverSubsteps = 0;
 		std::vector<PointJoint> allPointJoints;
 		std::vector<HingeJoint> allHingeJoints;
+		std::vector<PointJointRow> pointJointRows;
+		std::vector<HingeJointRow> hingeJointRows;
+
+		size_t ColliderPairKeyHash::operator()(const ColliderPairKey& i_key) const
+		{
+			size_t hashA = std::hash<Collider*>()(i_key.colliderA);
+			size_t hashB = std::hash<Collider*>()(i_key.colliderB);
+			return hashA ^ (hashB + 0x9e3779b9 + (hashA << 6) + (hashA >> 2));
+		}
+
+		ColliderPairKey MakeColliderPairKey(Collider* i_A, Collider* i_B)
+		{
+			ColliderPairKey key;
+			key.colliderA = i_A < i_B ? i_A : i_B;
+			key.colliderB = i_A < i_B ? i_B : i_A;
+			return key;
+		}
+
+		ContactManifold3D* FindManifold(Collider* i_A, Collider* i_B)
+		{
+			auto it = manifoldCache.find(MakeColliderPairKey(i_A, i_B));
+			if (it == manifoldCache.end()) return nullptr;
+			return &allManifolds[it->second];
+		}
+
+		void AddManifold(ContactManifold3D& i_manifold)
+		{
+			manifoldCache[MakeColliderPairKey(i_manifold.colliderA, i_manifold.colliderB)] = allManifolds.size();
+			allManifolds.push_back(i_manifold);
+		}
+
+		void RemoveManifoldAtIndex(size_t i_index)
+		{
+			//a lost contact may have been supporting a sleeping body
+			sRigidBodyState* pA = allManifolds[i_index].colliderA->m_pParentRigidBody;
+			sRigidBodyState* pB = allManifolds[i_index].colliderB->m_pParentRigidBody;
+			if (pA->isSleeping) pA->WakeUp();
+			if (pB->isSleeping) pB->WakeUp();
+			manifoldCache.erase(MakeColliderPairKey(allManifolds[i_index].colliderA, allManifolds[i_index].colliderB));
+			if (i_index != allManifolds.size() - 1)
+			{
+				allManifolds[i_index] = allManifolds.back();
+				manifoldCache[MakeColliderPairKey(allManifolds[i_index].colliderA, allManifolds[i_index].colliderB)] = i_index;
+			}
+			allManifolds.pop_back();
+		}
 
 		void ConstraintResolver(float i_dt)
 		{
-			for (int k = 0; k < constraintMaxNum; k++)//resolve contrains for 10 iterations
+			//islands are independent, each one iterates contacts, point joints and hinge joints until its residual converges
+			BuildIslands();
+			SolveIslands(i_dt, solverMaxIterations, false);
+		}
+
+		void UpdateColliderTransformation(sRigidBodyState& io_state)
+		{
+			Math::cMatrix_transformation local2World(io_state.orientation, io_state.position);
+			Math::cMatrix_transformation local2WorldRot(io_state.orientation, Math::sVector(0, 0, 0));
+			io_state.collider.UpdateTransformation(local2World, local2WorldRot);
+		}
+
+		void SubstepConstraintResolver(std::vector<GameCommon::GameObject *> & i_colliderObjects, float i_dt)
+		{
+			//TGS, every substep applies gravity, runs one biased sweep, moves the bodies and runs one relax sweep
+			BuildIslands();
+			float h = i_dt / static_cast<float>(solverSubsteps);
+			for (int s = 0; s < solverSubsteps; s++)
 			{
-				CollisionResolver(i_dt, k);
-				PointJointsResolver(i_dt);
-				HingeJointsSolver(i_dt);
+				for (size_t i = 0; i < i_colliderObjects.size(); i++)
+				{
+					sRigidBodyState& state = i_colliderObjects[i]->m_State;
+					if (state.hasGravity && !state.isStatic && !state.isSleeping) state.UpdateVelocity(h);
+				}
+				SolveIslands(h, 1, false);
+				for (size_t i = 0; i < i_colliderObjects.size(); i++)
+				{
+					sRigidBodyState& state = i_colliderObjects[i]->m_State;
+					if (state.isStatic || state.isSleeping) continue;
+					state.UpdatePosition(h);
+					state.UpdateOrientation(h);
+					UpdateColliderTransformation(state);
+				}
+				//contacts follow their local anchors instead of running the narrowphase again
+				for (size_t i = 0; i < allManifolds.size(); i++)
+				{
+					ContactManifold3D& manifold = allManifolds[i];
+					for (int j = 0; j < manifold.numContacts; j++)
+					{
+						Contact& contact = manifold.m_contacts[j];
+						contact.globalPositionA = manifold.colliderA->m_transformation * contact.localPositionA;
+						contact.globalPositionB = manifold.colliderB->m_transformation * contact.localPositionB;
+						contact.depth = Math::Dot(contact.globalPositionA - contact.globalPositionB, contact.normal);
+						//the impulses of this substep warm start the next one
+						contact.enableWarmStart = true;
+					}
+				}
+				SolveIslands(h, 1, true);
 			}
 		}
 
@@ -70,9 +167,13 @@ namespace sca2025 {
 				Math::cMatrix_transformation local2World(i_colliderObjects[i]->m_State.orientation, i_colliderObjects[i]->m_State.position);
 				Math::cMatrix_transformation local2WorldRot(i_colliderObjects[i]->m_State.orientation, Math::sVector(0, 0, 0));
 				i_colliderObjects[i]->m_State.collider.UpdateTransformation(local2World, local2WorldRot);
-				if (i_colliderObjects[i]->m_State.hasGravity && !i_colliderObjects[i]->m_State.isStatic)
+				//sleeping bodies have zero velocity, anything else was written from outside
+				sRigidBodyState& state = i_colliderObjects[i]->m_State;
+				if (state.isSleeping && (state.velocity.GetLengthSQ() > 0.0f || state.angularVelocity.GetLengthSQ() > 0.0f)) state.WakeUp();
+				//substeps apply gravity themselves
+				if (state.hasGravity && !state.isStatic && !state.isSleeping && solverSubsteps <= 0)
 				{
-					i_colliderObjects[i]->m_State.UpdateVelocity(i_dt);
+					state.UpdateVelocity(i_dt);
 				}
 			}
 			for (size_t i = 0; i < i_noColliderObjects.size(); i++)
@@ -83,53 +184,84 @@ namespace sca2025 {
 				}
 			}
 
+			//broadphase
+			SweepAndPrune(i_colliderObjects, broadphasePairs);
+			//pairs that left the broadphase are never visited by the narrowphase, drop their manifolds here
+			for (size_t k = 0; k < allManifolds.size();)
+			{
+				if (!AABBOverlap(ComputeWorldAABB(*allManifolds[k].colliderA->m_pParentRigidBody), ComputeWorldAABB(*allManifolds[k].colliderB->m_pParentRigidBody)))
+				{
+					RemoveManifoldAtIndex(k);
+				}
+				else
+				{
+					k++;
+				}
+			}
+
 			//collision detection
-			for (int i = 0; i < colliderCounts - 1; i++)
+			narrowphaseFrame++;
+			for (size_t p = 0; p < broadphasePairs.size(); p++)
 			{
-				for (int j = i + 1; j < colliderCounts; j++)
+				Collider* colliderA = &i_colliderObjects[broadphasePairs[p].indexA]->m_State.collider;
+				Collider* colliderB = &i_colliderObjects[broadphasePairs[p].indexB]->m_State.collider;
+				//seed GJK with last frame's direction, the cache is keyed by the ordered pair so flip it if needed
+				ColliderPairKey key = MakeColliderPairKey(colliderA, colliderB);
+				GJKCacheEntry& cacheEntry = gjkCache[key];
+				float flip = key.colliderA == colliderA ? 1.0f : -1.0f;
+				Math::sVector searchDir = cacheEntry.searchDir * flip;
+				//pairs without an awake dynamic body keep their manifold untouched
+				sRigidBodyState* pA = colliderA->m_pParentRigidBody;
+				sRigidBodyState* pB = colliderB->m_pParentRigidBody;
+				if ((pA->isStatic || pA->isSleeping) && (pB->isStatic || pB->isSleeping))
 				{
-					Contact contact;
-					if (i_colliderObjects[i]->m_State.collider.IsCollided(i_colliderObjects[j]->m_State.collider, contact))
+					cacheEntry.frame = narrowphaseFrame;
+					continue;
+				}
+				Contact contacts[NARROWPHASE_MAX_CONTACTS];
+				bool fullManifold;
+				int numContacts = Collide(*colliderA, *colliderB, contacts, fullManifold, searchDir);
+				cacheEntry.searchDir = searchDir * flip;
+				cacheEntry.frame = narrowphaseFrame;
+				if (numContacts > 0)
+				{
+					//add contact to correct manifold
+					ContactManifold3D* pManifold = FindManifold(colliderA, colliderB);
+					if (!pManifold)
+					{
+						ContactManifold3D manifold;
+						manifold.colliderA = colliderA;
+						manifold.colliderB = colliderB;
+						AddManifold(manifold);
+						pManifold = &allManifolds.back();
+					}
+					if (fullManifold)
+					{
+						ReplaceManifold(contacts, numContacts, *pManifold);
+					}
+					else if (pManifold->numContacts == 0)
 					{
-						//add contact to correct manifold
-						bool manifoldExist = false;
-						for (size_t k = 0; k < allManifolds.size(); k++)
-						{
-							//ContactManifold3D* pManifold = i_colliderObjects[i]->m_State.collider.m_pManifolds[k];
-							if ((allManifolds[k].m_contacts->colliderA == &i_colliderObjects[i]->m_State.collider && allManifolds[k].m_contacts->colliderB == &i_colliderObjects[j]->m_State.collider) ||
-								(allManifolds[k].m_contacts->colliderA == &i_colliderObjects[j]->m_State.collider && allManifolds[k].m_contacts->colliderB == &i_colliderObjects[i]->m_State.collider))
-							{
-								manifoldExist = true;
-								//merge contact
-								MergeContact(contact, allManifolds[k]);
-								break;
-							}
-						}
-						if (!manifoldExist)
-						{
-							ContactManifold3D manifold;
-							manifold.AddContact(contact);
-							allManifolds.push_back(manifold);
-							//i_colliderObjects[i]->m_State.collider.m_pManifolds.push_back(&allManifolds.back());
-							//i_colliderObjects[j]->m_State.collider.m_pManifolds.push_back(&allManifolds.back());
-						}
+						pManifold->AddContact(contacts[0]);
 					}
 					else
 					{
-						for (size_t k = 0; k < allManifolds.size(); k++)
-						{
-							//ContactManifold3D* pManifold = i_colliderObjects[i]->m_State.collider.m_pManifolds[k];
-							if ((allManifolds[k].m_contacts->colliderA == &i_colliderObjects[i]->m_State.collider && allManifolds[k].m_contacts->colliderB == &i_colliderObjects[j]->m_State.collider) ||
-								(allManifolds[k].m_contacts->colliderA == &i_colliderObjects[j]->m_State.collider && allManifolds[k].m_contacts->colliderB == &i_colliderObjects[i]->m_State.collider))
-							{
-								allManifolds[k] = allManifolds.back();
-								allManifolds.pop_back();
-								//allManifolds.shrink_to_fit();
-								break;
-							}
-						}
+						MergeContact(contacts[0], *pManifold);
 					}
 				}
+				else
+				{
+					auto it = manifoldCache.find(key);
+					if (it != manifoldCache.end())
+					{
+						RemoveManifoldAtIndex(it->second);
+					}
+				}
+			}
+			//drop the search directions of pairs that left the broadphase
+			for (auto it = gjkCache.begin(); it != gjkCache.end();)
+			{
+				if (it->second.frame != narrowphaseFrame) it = gjkCache.erase(it);
+				else ++it;
 			}
 			/*
 			for (size_t i = 0; i < allManifolds.size(); i++)
@@ -155,11 +287,13 @@ namespace sca2025 {
 			}
 			*/
 			//resolve collision
-			ConstraintResolver(i_dt);
+			if (solverSubsteps > 0) SubstepConstraintResolver(i_colliderObjects, i_dt);
+			else ConstraintResolver(i_dt);
 			
-			//integration
+			//integration, substeps already moved the collider objects
 			for (int i = 0; i < colliderCounts; i++)
 			{
+				if (i_colliderObjects[i]->m_State.isSleeping || solverSubsteps > 0) continue;
 				i_colliderObjects[i]->m_State.UpdatePosition(i_dt);
 				i_colliderObjects[i]->m_State.UpdateOrientation(i_dt);
 			}
@@ -171,6 +305,8 @@ namespace sca2025 {
 					i_noColliderObjects[i]->m_State.UpdateOrientation(i_dt);
 				}
 			}
+			UpdateSleepState(i_colliderObjects);
+			BuildQueryTree(i_colliderObjects);
 		}
 		
 		//*************following functions ared used for continuious collision detection************************//
@@ -197,11 +333,13 @@ namespace sca2025 {
 		void PhysicsUpdate(std::vector<GameCommon::GameObject *> & o_allGameObjects, float i_dt) {
 			float frameTime = i_dt;
 			
+			BeginContinuousCollision(o_allGameObjects, i_dt);
 			while (frameTime > 0) {
 				CollisionPair earliestCollision;
-				if (FindEarliestCollision(o_allGameObjects, frameTime, earliestCollision)) {
+				if (PopEarliestCollision(o_allGameObjects, earliestCollision)) {
 					MoveObjectsForward(o_allGameObjects, earliestCollision.collisionTime);
 					ResolveCollision(earliestCollision);
+					UpdateContinuousCollision(o_allGameObjects, earliestCollision);
 					frameTime = frameTime - earliestCollision.collisionTime;
 				}
 				else {
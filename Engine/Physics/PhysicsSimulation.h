@@ -3,6 +3,7 @@
 #include "PointJoint.h"
 #include "HingeJoint.h"
 #include <vector>
+#include <unordered_map>
 #define constraintMaxNum 50
 namespace sca2025 {
 	struct CollisionPair;
@@ -13,11 +14,37 @@ namespace sca2025 {
 		extern bool simPause;
 		extern bool nextSimStep;
 		extern bool simPlay;
+		extern int solverSubsteps;//TGS substeps per step with one biased and one relax sweep each, 0 runs the iterative solver
+
+		//manifolds persist across frames, manifoldCache maps a collider pair to its index in allManifolds
+		struct ColliderPairKey {
+			Collider* colliderA;
+			Collider* colliderB;
+			bool operator==(const ColliderPairKey& i_other) const { return colliderA == i_other.colliderA && colliderB == i_other.colliderB; }
+		};
+		struct ColliderPairKeyHash {
+			size_t operator()(const ColliderPairKey& i_key) const;
+		};
 
 		extern std::vector<ContactManifold3D> allManifolds;
+		extern std::unordered_map<ColliderPairKey, size_t, ColliderPairKeyHash> manifoldCache;
+		//last GJK search direction of every broadphase pair, stored for the ordered key and dropped when the pair leaves the broadphase
+		struct GJKCacheEntry {
+			Math::sVector searchDir;
+			unsigned int frame = 0;
+		};
+		extern std::unordered_map<ColliderPairKey, GJKCacheEntry, ColliderPairKeyHash> gjkCache;
 		extern std::vector<PointJoint> allPointJoints;
 		extern std::vector<HingeJoint> allHingeJoints;
+		//rows prepared from allPointJoints and allHingeJoints at the start of a solve, same indices
+		extern std::vector<PointJointRow> pointJointRows;
+		extern std::vector<HingeJointRow> hingeJointRows;
 		
+		ColliderPairKey MakeColliderPairKey(Collider* i_A, Collider* i_B);
+		ContactManifold3D* FindManifold(Collider* i_A, Collider* i_B);
+		void AddManifold(ContactManifold3D& i_manifold);
+		void RemoveManifoldAtIndex(size_t i_index);
+
 		void InitializePhysics(std::vector<GameCommon::GameObject *> & i_colliderObjects, std::vector<GameCommon::GameObject *> & i_noColliderObjects);
 		//void ConstraintResolver(std::vector<ContactManifold3D>& o_allManifolds, float i_dt);
 		//void RunPhysics(std::vector<GameCommon::GameObject *> & i_allGameObjects, std::vector<GameCommon::GameObject *> & i_debugGraphics, Assets::cHandle<Mesh> i_debugMesh, Effect* i_pDebugEffect, float i_dt);
@@ -6,23 +6,21 @@
 using namespace Eigen;
 void sca2025::Physics::PointJointsResolver(float i_dt)
 {
+	SolverResidual residual;
 	for (size_t i = 0; i < allPointJoints.size(); i++)
 	{
-		allPointJoints[i].ResolvePointJointConstrain(i_dt);
+		allPointJoints[i].ResolvePointJointConstrain(i_dt, residual);
 	}
 }
 
-void sca2025::Physics::PointJoint::ResolvePointJointConstrain(float i_dt)
+void sca2025::Physics::PointJoint::PrepareRow(float i_dt, PointJointRow& o_row)
 {
 	Math::cMatrix_transformation Local2World_rotation(pGameObject->m_State.orientation, Math::sVector(0.0f, 0.0f, 0.0f));
 	Math::sVector worldExtend = Local2World_rotation * extend;
 	anchor = pParentObject->m_State.position;
 	Math::sVector cPosVector = (pGameObject->m_State.position + worldExtend) - anchor;
 	Vector3f cPos(cPosVector.x, cPosVector.y, cPosVector.z);
-	Math::sVector cVelVector = pGameObject->m_State.velocity + Math::Cross(pGameObject->m_State.angularVelocity, worldExtend);
-	Vector3f cVel(cVelVector.x, cVelVector.y, cVelVector.z);
 
-	// compute lambda
 	Matrix3f S;
 	S.setZero();
 	S(0, 1) = worldExtend.z;
@@ -32,37 +30,44 @@ void sca2025::Physics::PointJoint::ResolvePointJointConstrain(float i_dt)
 	S(2, 0) = worldExtend.y;
 	S(2, 1) = -worldExtend.x;
 	Matrix3f inertiaInv;
-	inertiaInv(0, 0) = pGameObject->m_State.globalInverseInertiaTensor.m_00;
-	inertiaInv(0, 1) = pGameObject->m_State.globalInverseInertiaTensor.m_01;
-	inertiaInv(0, 2) = pGameObject->m_State.globalInverseInertiaTensor.m_02;
-	inertiaInv(1, 0) = pGameObject->m_State.globalInverseInertiaTensor.m_10;
-	inertiaInv(1, 1) = pGameObject->m_State.globalInverseInertiaTensor.m_11;
-	inertiaInv(1, 2) = pGameObject->m_State.globalInverseInertiaTensor.m_12;
-	inertiaInv(2, 0) = pGameObject->m_State.globalInverseInertiaTensor.m_20;
-	inertiaInv(2, 1) = pGameObject->m_State.globalInverseInertiaTensor.m_21;
-	inertiaInv(2, 2) = pGameObject->m_State.globalInverseInertiaTensor.m_22;
+	Math::NativeMatrix2EigenMatrix(pGameObject->m_State.globalInverseInertiaTensor, inertiaInv);
 
 	Matrix3f I;
 	I.setIdentity();
 	float massInv = 1 / pGameObject->m_State.mass;
-	Matrix3f effectiveMass = (massInv * I + S * inertiaInv * S.transpose()).inverse();
 	float beta = 1.6f;
-	Vector3f lambda = effectiveMass * (-cVel - (beta / i_dt)*cPos);
+	o_row.pBody = &pGameObject->m_State;
+	o_row.angularJacobian = S;
+	o_row.angularResponse = inertiaInv * S.transpose();
+	o_row.effectiveMass = (massInv * I + S * inertiaInv * S.transpose()).inverse();
+	o_row.bias = (beta / i_dt) * cPos;
+	o_row.inverseMass = massInv;
+}
+
+void sca2025::Physics::PointJoint::ResolvePointJointConstrain(float i_dt, SolverResidual& io_residual)
+{
+	PointJointRow row;
+	PrepareRow(i_dt, row);
+	SolvePointJointRow(row, io_residual);
+}
+
+void sca2025::Physics::SolvePointJointRow(PointJointRow& io_row, SolverResidual& io_residual)
+{
+	sRigidBodyState& state = *io_row.pBody;
+	Vector3f v(state.velocity.x, state.velocity.y, state.velocity.z);
+	Vector3f w(state.angularVelocity.x, state.angularVelocity.y, state.angularVelocity.z);
+
+	// compute lambda
+	Vector3f velocityError = v + io_row.angularJacobian * w + io_row.bias;
+	Vector3f lambda = -(io_row.effectiveMass * velocityError);
+	io_residual.Add(lambda.cwiseAbs().maxCoeff(), velocityError.cwiseAbs().maxCoeff());
 
 	//correct velocity
-	Vector3f dV = (1 / pGameObject->m_State.mass)*lambda;
-	Math::sVector dVVector;
-	dVVector.x = dV(0);
-	dVVector.y = dV(1);
-	dVVector.z = dV(2);
-	pGameObject->m_State.velocity += dVVector;
-	pGameObject->m_State.velocity *= 0.999f;//damping
+	Vector3f dV = io_row.inverseMass * lambda;
+	state.velocity += Math::EigenVector2nativeVector(dV);
+	state.velocity *= 0.999f;//damping
 
-	Vector3f dA = inertiaInv * S.transpose() * lambda;
-	Math::sVector dAVector;
-	dAVector.x = dA(0);
-	dAVector.y = dA(1);
-	dAVector.z = dA(2);
-	pGameObject->m_State.angularVelocity += dAVector;
-	pGameObject->m_State.angularVelocity *= 0.999f;//damping
+	Vector3f dA = io_row.angularResponse * lambda;
+	state.angularVelocity += Math::EigenVector2nativeVector(dA);
+	state.angularVelocity *= 0.999f;//damping
 }
\ No newline at end of file
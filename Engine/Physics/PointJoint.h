@@ -1,12 +1,27 @@
 #pragma once
 #include "Engine/GameCommon/GameObject.h"
 #include <Engine/Math/sVector.h>
+#include "External/EigenLibrary/Eigen/Dense"
+#include "Island.h"
 
 namespace sca2025
 {
 	namespace Physics
 	{
 		void PointJointsResolver(float i_dt);
+
+		//point joint block prepared once per step, positions do not change while the solver iterates
+		//fixed size blocks are unaligned so the rows can be stored contiguously in a std::vector
+		struct PointJointRow
+		{
+			sRigidBodyState* pBody;
+			Eigen::Matrix<float, 3, 3, Eigen::DontAlign> angularJacobian;//S, constraint velocity is v + S * w
+			Eigen::Matrix<float, 3, 3, Eigen::DontAlign> angularResponse;//I^-1 * S^T
+			Eigen::Matrix<float, 3, 3, Eigen::DontAlign> effectiveMass;//(m^-1 + S * I^-1 * S^T)^-1
+			Eigen::Matrix<float, 3, 1, Eigen::DontAlign> bias;//beta / dt * position error
+			float inverseMass;
+		};
+		void SolvePointJointRow(PointJointRow& io_row, SolverResidual& io_residual);
 		
 		class PointJoint
 		{
@@ -16,7 +31,8 @@ namespace sca2025
 			Math::sVector anchor;
 			Math::sVector extend;
 
-			void ResolvePointJointConstrain(float i_dt);
+			void PrepareRow(float i_dt, PointJointRow& o_row);
+			void ResolvePointJointConstrain(float i_dt, SolverResidual& io_residual);
 		};
 	}
 }
\ No newline at end of file
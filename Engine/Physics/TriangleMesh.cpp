@@ -0,0 +1,286 @@
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+
+#include "TriangleMesh.h"
+
+#define BVH_NUM_BINS 12
+#define BVH_MAX_DEPTH 64
+
+namespace sca2025 {
+	namespace Physics {
+		int bvhLeafSize = 4;
+
+		namespace {
+			struct BuildBox {
+				Math::sVector boxMin = Math::sVector(FLT_MAX, FLT_MAX, FLT_MAX);
+				Math::sVector boxMax = Math::sVector(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+
+				void Grow(const Math::sVector& i_p)
+				{
+					boxMin = Math::sVector(std::min(boxMin.x, i_p.x), std::min(boxMin.y, i_p.y), std::min(boxMin.z, i_p.z));
+					boxMax = Math::sVector(std::max(boxMax.x, i_p.x), std::max(boxMax.y, i_p.y), std::max(boxMax.z, i_p.z));
+				}
+				void Grow(const BuildBox& i_box)
+				{
+					if (i_box.boxMin.x > i_box.boxMax.x) return;//empty bin
+					Grow(i_box.boxMin);
+					Grow(i_box.boxMax);
+				}
+				float Area() const
+				{
+					Math::sVector e = boxMax - boxMin;
+					if (e.x < 0.0f) return 0.0f;
+					return e.x * e.y + e.y * e.z + e.z * e.x;
+				}
+			};
+
+			float Component(const Math::sVector& i_v, int i_axis)
+			{
+				if (i_axis == 0) return i_v.x;
+				if (i_axis == 1) return i_v.y;
+				return i_v.z;
+			}
+
+			struct Builder {
+				TriangleMesh& mesh;
+				std::vector<BuildBox> triangleBoxes;
+				std::vector<Math::sVector> centroids;
+
+				explicit Builder(TriangleMesh& io_mesh) : mesh(io_mesh) {}
+
+				//splits triangleOrder[first, first + count) and returns the node index
+				int Build(int i_first, int i_count, int i_depth)
+				{
+					int nodeIndex = static_cast<int>(mesh.nodes.size());
+					mesh.nodes.push_back(BVHNode());
+					BuildBox box, centroidBox;
+					for (int i = i_first; i < i_first + i_count; i++)
+					{
+						box.Grow(triangleBoxes[mesh.triangleOrder[i]]);
+						centroidBox.Grow(centroids[mesh.triangleOrder[i]]);
+					}
+					mesh.nodes[nodeIndex].boxMin = box.boxMin;
+					mesh.nodes[nodeIndex].boxMax = box.boxMax;
+
+					int axis = -1, split = 0;
+					if (i_count > bvhLeafSize && i_depth < BVH_MAX_DEPTH) FindSplit(i_first, i_count, box, centroidBox, axis, split);
+					if (axis < 0)
+					{
+						MakeLeaf(nodeIndex, i_first, i_count);
+						return nodeIndex;
+					}
+
+					//partition the triangles around the chosen bin boundary
+					float lower = Component(centroidBox.boxMin, axis);
+					float scale = BVH_NUM_BINS / (Component(centroidBox.boxMax, axis) - lower);
+					int* begin = mesh.triangleOrder.data() + i_first;
+					int* middle = std::partition(begin, begin + i_count, [&](int i_triangle) {
+						int bin = std::min(BVH_NUM_BINS - 1, static_cast<int>((Component(centroids[i_triangle], axis) - lower) * scale));
+						return bin < split;
+					});
+					int leftCount = static_cast<int>(middle - begin);
+					if (leftCount == 0 || leftCount == i_count)
+					{
+						MakeLeaf(nodeIndex, i_first, i_count);
+						return nodeIndex;
+					}
+
+					Build(i_first, leftCount, i_depth + 1);
+					int right = Build(i_first + leftCount, i_count - leftCount, i_depth + 1);
+					mesh.nodes[nodeIndex].rightChild = right;
+					mesh.nodes[nodeIndex].numTriangles = 0;
+					return nodeIndex;
+				}
+
+				void MakeLeaf(int i_node, int i_first, int i_count)
+				{
+					mesh.nodes[i_node].rightChild = -1;
+					mesh.nodes[i_node].firstTriangle = i_first;
+					mesh.nodes[i_node].numTriangles = i_count;
+				}
+
+				//binned SAH, o_axis stays -1 when no split beats a leaf
+				void FindSplit(int i_first, int i_count, const BuildBox& i_box, const BuildBox& i_centroidBox, int& o_axis, int& o_split)
+				{
+					float bestCost = i_box.Area() * static_cast<float>(i_count);
+					for (int axis = 0; axis < 3; axis++)
+					{
+						float lower = Component(i_centroidBox.boxMin, axis);
+						float extent = Component(i_centroidBox.boxMax, axis) - lower;
+						if (extent <= 1.0e-6f) continue;
+						float scale = BVH_NUM_BINS / extent;
+
+						BuildBox bins[BVH_NUM_BINS];
+						int binCounts[BVH_NUM_BINS] = { 0 };
+						for (int i = i_first; i < i_first + i_count; i++)
+						{
+							int triangle = mesh.triangleOrder[i];
+							int bin = std::min(BVH_NUM_BINS - 1, static_cast<int>((Component(centroids[triangle], axis) - lower) * scale));
+							bins[bin].Grow(triangleBoxes[triangle]);
+							binCounts[bin]++;
+						}
+
+						//sweep from the right to get the cost of every right side
+						float rightArea[BVH_NUM_BINS];
+						int rightCount[BVH_NUM_BINS];
+						BuildBox right;
+						int count = 0;
+						for (int b = BVH_NUM_BINS - 1; b > 0; b--)
+						{
+							right.Grow(bins[b]);
+							count += binCounts[b];
+							rightArea[b] = right.Area();
+							rightCount[b] = count;
+						}
+						BuildBox left;
+						count = 0;
+						for (int b = 1; b < BVH_NUM_BINS; b++)
+						{
+							left.Grow(bins[b - 1]);
+							count += binCounts[b - 1];
+							if (count == 0 || rightCount[b] == 0) continue;
+							float cost = left.Area() * static_cast<float>(count) + rightArea[b] * static_cast<float>(rightCount[b]);
+							if (cost < bestCost)
+							{
+								bestCost = cost;
+								o_axis = axis;
+								o_split = b;
+							}
+						}
+					}
+				}
+			};
+
+			bool BoxOverlap(const Math::sVector& i_minA, const Math::sVector& i_maxA, const Math::sVector& i_minB, const Math::sVector& i_maxB)
+			{
+				return i_minA.x <= i_maxB.x && i_maxA.x >= i_minB.x
+					&& i_minA.y <= i_maxB.y && i_maxA.y >= i_minB.y
+					&& i_minA.z <= i_maxB.z && i_maxA.z >= i_minB.z;
+			}
+		}
+
+		void TriangleMesh::QueryBox(const Math::sVector& i_min, const Math::sVector& i_max, std::vector<int>& o_triangles) const
+		{
+			if (nodes.empty()) return;
+			int stack[BVH_MAX_DEPTH * 2];
+			int stackSize = 0;
+			stack[stackSize++] = 0;
+			while (stackSize > 0)
+			{
+				const BVHNode& node = nodes[stack[--stackSize]];
+				if (!BoxOverlap(node.boxMin, node.boxMax, i_min, i_max)) continue;
+				if (node.numTriangles > 0)
+				{
+					for (int i = node.firstTriangle; i < node.firstTriangle + node.numTriangles; i++) o_triangles.push_back(triangleOrder[i]);
+					continue;
+				}
+				stack[stackSize++] = node.rightChild;
+				stack[stackSize++] = static_cast<int>(&node - nodes.data()) + 1;
+			}
+		}
+
+		bool TriangleMesh::Raycast(const Math::sVector& i_origin, const Math::sVector& i_direction, float& io_distance, int& o_triangle) const
+		{
+			if (nodes.empty()) return false;
+			Math::sVector inverse(1.0f / i_direction.x, 1.0f / i_direction.y, 1.0f / i_direction.z);
+			bool hit = false;
+			int stack[BVH_MAX_DEPTH * 2];
+			int stackSize = 0;
+			stack[stackSize++] = 0;
+			while (stackSize > 0)
+			{
+				int nodeIndex = stack[--stackSize];
+				const BVHNode& node = nodes[nodeIndex];
+				if (!RayBoxOverlap(i_origin, inverse, node.boxMin, node.boxMax, io_distance)) continue;
+				if (node.numTriangles > 0)
+				{
+					for (int i = node.firstTriangle; i < node.firstTriangle + node.numTriangles; i++)
+					{
+						int triangle = triangleOrder[i];
+						float t;
+						if (RayTriangle(i_origin, i_direction, vertices[indices[triangle * 3]], vertices[indices[triangle * 3 + 1]], vertices[indices[triangle * 3 + 2]], t) && t < io_distance)
+						{
+							io_distance = t;
+							o_triangle = triangle;
+							hit = true;
+						}
+					}
+					continue;
+				}
+				stack[stackSize++] = node.rightChild;
+				stack[stackSize++] = nodeIndex + 1;
+			}
+			return hit;
+		}
+
+		bool RayBoxOverlap(const Math::sVector& i_origin, const Math::sVector& i_inverseDirection, const Math::sVector& i_min, const Math::sVector& i_max, float i_maxDistance)
+		{
+			float t1 = (i_min.x - i_origin.x) * i_inverseDirection.x, t2 = (i_max.x - i_origin.x) * i_inverseDirection.x;
+			float tEnter = std::min(t1, t2), tExit = std::max(t1, t2);
+			t1 = (i_min.y - i_origin.y) * i_inverseDirection.y; t2 = (i_max.y - i_origin.y) * i_inverseDirection.y;
+			tEnter = std::max(tEnter, std::min(t1, t2)); tExit = std::min(tExit, std::max(t1, t2));
+			t1 = (i_min.z - i_origin.z) * i_inverseDirection.z; t2 = (i_max.z - i_origin.z) * i_inverseDirection.z;
+			tEnter = std::max(tEnter, std::min(t1, t2)); tExit = std::min(tExit, std::max(t1, t2));
+			return tExit >= std::max(tEnter, 0.0f) && tEnter <= i_maxDistance;
+		}
+
+		bool RayTriangle(const Math::sVector& i_origin, const Math::sVector& i_direction, const Math::sVector& i_a, const Math::sVector& i_b, const Math::sVector& i_c, float& o_distance)
+		{
+			//Moller-Trumbore
+			Math::sVector edge1 = i_b - i_a;
+			Math::sVector edge2 = i_c - i_a;
+			Math::sVector p = Math::Cross(i_direction, edge2);
+			float determinant = Math::Dot(edge1, p);
+			if (std::abs(determinant) < 1.0e-8f) return false;
+			float inverseDeterminant = 1.0f / determinant;
+			Math::sVector s = i_origin - i_a;
+			float u = Math::Dot(s, p) * inverseDeterminant;
+			if (u < 0.0f || u > 1.0f) return false;
+			Math::sVector q = Math::Cross(s, edge1);
+			float v = Math::Dot(i_direction, q) * inverseDeterminant;
+			if (v < 0.0f || u + v > 1.0f) return false;
+			o_distance = Math::Dot(edge2, q) * inverseDeterminant;
+			return o_distance >= 0.0f;
+		}
+
+		std::shared_ptr<const TriangleMesh> BuildTriangleMesh(const std::vector<Math::sVector>& i_vertices, const std::vector<int>& i_indices, bool i_twoSided)
+		{
+			TriangleMesh* pMesh = new TriangleMesh();
+			TriangleMesh& mesh = *pMesh;
+			mesh.vertices = i_vertices;
+			mesh.indices = i_indices;
+			mesh.twoSided = i_twoSided;
+			int numTriangles = mesh.GetTriangleCount();
+
+			Builder builder(mesh);
+			builder.triangleBoxes.resize(numTriangles);
+			builder.centroids.resize(numTriangles);
+			mesh.normals.resize(numTriangles);
+			mesh.triangleOrder.resize(numTriangles);
+			BuildBox bounds;
+			for (int t = 0; t < numTriangles; t++)
+			{
+				const Math::sVector& a = i_vertices[i_indices[t * 3]];
+				const Math::sVector& b = i_vertices[i_indices[t * 3 + 1]];
+				const Math::sVector& c = i_vertices[i_indices[t * 3 + 2]];
+				builder.triangleBoxes[t].Grow(a);
+				builder.triangleBoxes[t].Grow(b);
+				builder.triangleBoxes[t].Grow(c);
+				builder.centroids[t] = (a + b + c) / 3.0f;
+				Math::sVector normal = Math::Cross(b - a, c - a);
+				mesh.normals[t] = normal.GetLengthSQ() > 0.0f ? normal.GetNormalized() : Math::sVector(0.0f, 1.0f, 0.0f);
+				mesh.triangleOrder[t] = t;
+				bounds.Grow(builder.triangleBoxes[t]);
+			}
+			mesh.boundsMin = numTriangles > 0 ? bounds.boxMin : Math::sVector();
+			mesh.boundsMax = numTriangles > 0 ? bounds.boxMax : Math::sVector();
+			if (numTriangles > 0)
+			{
+				mesh.nodes.reserve(static_cast<size_t>(numTriangles) * 2);
+				builder.Build(0, numTriangles, 0);
+			}
+			return std::shared_ptr<const TriangleMesh>(pMesh);
+		}
+	}
+}
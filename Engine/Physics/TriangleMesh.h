@@ -0,0 +1,44 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <Engine/Math/sVector.h>
+
+namespace sca2025 {
+	namespace Physics {
+		//node of a flattened BVH, children of an inner node are the next node and rightChild
+		struct BVHNode {
+			Math::sVector boxMin;
+			Math::sVector boxMax;
+			int rightChild;//inner nodes
+			int firstTriangle;//leaves, into TriangleMesh::triangleOrder
+			int numTriangles;//0 for inner nodes
+		};
+
+		//static triangle soup in collider local space, counter clockwise triangles face outwards
+		struct TriangleMesh {
+			std::vector<Math::sVector> vertices;
+			std::vector<int> indices;//three per triangle
+			std::vector<Math::sVector> normals;//one per triangle
+			std::vector<BVHNode> nodes;//nodes[0] is the root
+			std::vector<int> triangleOrder;//triangles grouped by leaf
+			Math::sVector boundsMin;
+			Math::sVector boundsMax;
+			bool twoSided = false;//open surfaces push colliders out on the side of their center, closed meshes only outwards
+
+			int GetTriangleCount() const { return static_cast<int>(indices.size() / 3); }
+			//appends the triangles of every leaf overlapping the local space box, candidates for the exact tests
+			void QueryBox(const Math::sVector& i_min, const Math::sVector& i_max, std::vector<int>& o_triangles) const;
+			//closest front or back facing hit of the local space ray within io_distance, io_distance is shortened on a hit
+			bool Raycast(const Math::sVector& i_origin, const Math::sVector& i_direction, float& io_distance, int& o_triangle) const;
+		};
+
+		extern int bvhLeafSize;//largest number of triangles in a leaf
+
+		//slab test, i_inverseDirection is 1 / direction per component
+		bool RayBoxOverlap(const Math::sVector& i_origin, const Math::sVector& i_inverseDirection, const Math::sVector& i_min, const Math::sVector& i_max, float i_maxDistance);
+		bool RayTriangle(const Math::sVector& i_origin, const Math::sVector& i_direction, const Math::sVector& i_a, const Math::sVector& i_b, const Math::sVector& i_c, float& o_distance);
+
+		//builds the BVH with the binned surface area heuristic, i_twoSided for open surfaces
+		std::shared_ptr<const TriangleMesh> BuildTriangleMesh(const std::vector<Math::sVector>& i_vertices, const std::vector<int>& i_indices, bool i_twoSided = false);
+	}
+}
@@ -0,0 +1,322 @@
+#include <cmath>
+#include <algorithm>
+
+#include "WorldQuery.h"
+#include "Broadphase.h"
+#include "sRigidBodyState.h"
+#include "Engine/GameCommon/GameObject.h"
+
+#define QUERY_MAX_PACKET 16
+#define QUERY_STACK_SIZE 128
+
+namespace sca2025 {
+	namespace Physics {
+		int queryPacketSize = 8;
+
+		namespace {
+			//children of an inner node are the next node and rightChild, leaves hold one body
+			struct QueryNode {
+				Math::sVector boxMin;
+				Math::sVector boxMax;
+				int rightChild;
+				int body;//-1 for inner nodes
+			};
+
+			std::vector<QueryNode> queryNodes;
+			std::vector<sRigidBodyState*> queryBodies;
+			std::vector<AABB> queryBoxes;
+			std::vector<int> queryOrder;
+
+			float Component(const Math::sVector& i_v, int i_axis)
+			{
+				if (i_axis == 0) return i_v.x;
+				if (i_axis == 1) return i_v.y;
+				return i_v.z;
+			}
+
+			//median split along the longest axis of the box centers
+			int BuildNode(int i_first, int i_count)
+			{
+				int nodeIndex = static_cast<int>(queryNodes.size());
+				queryNodes.push_back(QueryNode());
+				Math::sVector boxMin(FLT_MAX, FLT_MAX, FLT_MAX), boxMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+				Math::sVector centerMin = boxMin, centerMax = boxMax;
+				for (int i = i_first; i < i_first + i_count; i++)
+				{
+					const AABB& box = queryBoxes[queryOrder[i]];
+					Math::sVector low = box.center - box.extends, high = box.center + box.extends;
+					boxMin = Math::sVector(std::min(boxMin.x, low.x), std::min(boxMin.y, low.y), std::min(boxMin.z, low.z));
+					boxMax = Math::sVector(std::max(boxMax.x, high.x), std::max(boxMax.y, high.y), std::max(boxMax.z, high.z));
+					centerMin = Math::sVector(std::min(centerMin.x, box.center.x), std::min(centerMin.y, box.center.y), std::min(centerMin.z, box.center.z));
+					centerMax = Math::sVector(std::max(centerMax.x, box.center.x), std::max(centerMax.y, box.center.y), std::max(centerMax.z, box.center.z));
+				}
+				queryNodes[nodeIndex].boxMin = boxMin;
+				queryNodes[nodeIndex].boxMax = boxMax;
+				if (i_count == 1)
+				{
+					queryNodes[nodeIndex].rightChild = -1;
+					queryNodes[nodeIndex].body = queryOrder[i_first];
+					return nodeIndex;
+				}
+
+				Math::sVector spread = centerMax - centerMin;
+				int axis = 0;
+				if (spread.y > spread.x) axis = 1;
+				if (spread.z > Component(spread, axis)) axis = 2;
+				int half = i_count / 2;
+				std::nth_element(queryOrder.begin() + i_first, queryOrder.begin() + i_first + half, queryOrder.begin() + i_first + i_count, [axis](int a, int b) {
+					return Component(queryBoxes[a].center, axis) < Component(queryBoxes[b].center, axis);
+				});
+				BuildNode(i_first, half);
+				int right = BuildNode(i_first + half, i_count - half);
+				queryNodes[nodeIndex].rightChild = right;
+				queryNodes[nodeIndex].body = -1;
+				return nodeIndex;
+			}
+
+			Math::sVector WorldToLocal(const Math::cMatrix_transformation& i_m, const Math::sVector& i_p)
+			{
+				Math::sVector d = i_p - i_m.GetTranslation();
+				return Math::sVector(i_m.m_00 * d.x + i_m.m_10 * d.y + i_m.m_20 * d.z, i_m.m_01 * d.x + i_m.m_11 * d.y + i_m.m_21 * d.z, i_m.m_02 * d.x + i_m.m_12 * d.y + i_m.m_22 * d.z);
+			}
+
+			Math::sVector LocalDirToWorld(const Math::cMatrix_transformation& i_m, const Math::sVector& i_d)
+			{
+				return Math::sVector(i_m.m_00 * i_d.x + i_m.m_01 * i_d.y + i_m.m_02 * i_d.z, i_m.m_10 * i_d.x + i_m.m_11 * i_d.y + i_m.m_12 * i_d.z, i_m.m_20 * i_d.x + i_m.m_21 * i_d.y + i_m.m_22 * i_d.z);
+			}
+
+			Math::sVector WorldDirToLocal(const Math::cMatrix_transformation& i_m, const Math::sVector& i_d)
+			{
+				return Math::sVector(i_m.m_00 * i_d.x + i_m.m_10 * i_d.y + i_m.m_20 * i_d.z, i_m.m_01 * i_d.x + i_m.m_11 * i_d.y + i_m.m_21 * i_d.z, i_m.m_02 * i_d.x + i_m.m_12 * i_d.y + i_m.m_22 * i_d.z);
+			}
+
+			//exact ray against the collider of i_body, shortens io_hit.distance on a closer hit
+			void RaycastBody(const RayQuery& i_ray, sRigidBodyState* i_body, RayHit& io_hit)
+			{
+				Collider& collider = i_body->collider;
+				const Math::cMatrix_transformation& m = collider.m_transformation;
+				float limit = std::min(io_hit.distance, i_ray.maxDistance);
+				if (collider.m_type == Sphere)
+				{
+					if (collider.m_hull->vertices.size() < 2) return;
+					Math::sVector center = m * collider.m_hull->vertices[0];
+					float r = collider.m_hull->vertices[1].GetLength();
+					Math::sVector offset = i_ray.origin - center;
+					float b = Math::Dot(offset, i_ray.direction);
+					float c = offset.GetLengthSQ() - r * r;
+					float discriminant = b * b - c;
+					if (discriminant < 0.0f) return;
+					float t = -b - std::sqrt(discriminant);
+					if (t < 0.0f) t = 0.0f;//origin inside the sphere
+					if (t > limit || (c > 0.0f && b > 0.0f)) return;
+					io_hit.pBody = i_body;
+					io_hit.distance = t;
+					io_hit.position = i_ray.origin + i_ray.direction * t;
+					io_hit.normal = c > 0.0f ? (io_hit.position - center).GetNormalized() : -i_ray.direction;
+				}
+				else if (collider.m_type == Plane)
+				{
+					if (collider.m_hull->vertices.size() < 2) return;
+					Math::sVector point = m * collider.m_hull->vertices[0];
+					Math::sVector normal = LocalDirToWorld(m, collider.m_hull->vertices[1]).GetNormalized();
+					float denominator = Math::Dot(normal, i_ray.direction);
+					if (denominator >= 0.0f) return;//parallel or from behind
+					float t = Math::Dot(normal, point - i_ray.origin) / denominator;
+					if (t < 0.0f || t > limit) return;
+					io_hit.pBody = i_body;
+					io_hit.distance = t;
+					io_hit.position = i_ray.origin + i_ray.direction * t;
+					io_hit.normal = normal;
+				}
+				else if (collider.m_type == Box)
+				{
+					if (collider.m_hull->vertices.empty()) return;
+					const ConvexHull& hull = *collider.m_hull;
+					Math::sVector origin = WorldToLocal(m, i_ray.origin);
+					Math::sVector direction = WorldDirToLocal(m, i_ray.direction);
+					Math::sVector boxMin = hull.boxCenter - hull.boxExtends, boxMax = hull.boxCenter + hull.boxExtends;
+					float tEnter = 0.0f, tExit = limit;
+					int enterAxis = -1;
+					float enterSign = 0.0f;
+					for (int k = 0; k < 3; k++)
+					{
+						float o = Component(origin, k), d = Component(direction, k);
+						float low = Component(boxMin, k), high = Component(boxMax, k);
+						if (std::abs(d) < 1.0e-12f)
+						{
+							if (o < low || o > high) return;
+							continue;
+						}
+						float t1 = (low - o) / d, t2 = (high - o) / d;
+						float sign = -1.0f;
+						if (t1 > t2) { std::swap(t1, t2); sign = 1.0f; }
+						if (t1 > tEnter) { tEnter = t1; enterAxis = k; enterSign = sign; }
+						tExit = std::min(tExit, t2);
+						if (tEnter > tExit) return;
+					}
+					Math::sVector localNormal = -direction;
+					if (enterAxis == 0) localNormal = Math::sVector(enterSign, 0.0f, 0.0f);
+					else if (enterAxis == 1) localNormal = Math::sVector(0.0f, enterSign, 0.0f);
+					else if (enterAxis == 2) localNormal = Math::sVector(0.0f, 0.0f, enterSign);
+					io_hit.pBody = i_body;
+					io_hit.distance = tEnter;
+					io_hit.position = i_ray.origin + i_ray.direction * tEnter;
+					io_hit.normal = LocalDirToWorld(m, localNormal);
+				}
+				else if (collider.m_type == TriMesh)
+				{
+					if (!collider.m_mesh) return;
+					Math::sVector origin = WorldToLocal(m, i_ray.origin);
+					Math::sVector direction = WorldDirToLocal(m, i_ray.direction);
+					float t = limit;
+					int triangle = -1;
+					if (!collider.m_mesh->Raycast(origin, direction, t, triangle)) return;
+					Math::sVector normal = LocalDirToWorld(m, collider.m_mesh->normals[triangle]);
+					io_hit.pBody = i_body;
+					io_hit.distance = t;
+					io_hit.position = i_ray.origin + i_ray.direction * t;
+					io_hit.normal = Math::Dot(normal, i_ray.direction) > 0.0f ? -normal : normal;
+				}
+			}
+
+			void RaycastSingle(const RayQuery& i_ray, RayHit& o_hit)
+			{
+				o_hit = RayHit();
+				if (queryNodes.empty()) return;
+				Math::sVector inverse(1.0f / i_ray.direction.x, 1.0f / i_ray.direction.y, 1.0f / i_ray.direction.z);
+				int stack[QUERY_STACK_SIZE];
+				int stackSize = 0;
+				stack[stackSize++] = 0;
+				while (stackSize > 0)
+				{
+					int nodeIndex = stack[--stackSize];
+					const QueryNode& node = queryNodes[nodeIndex];
+					if (!RayBoxOverlap(i_ray.origin, inverse, node.boxMin, node.boxMax, std::min(o_hit.distance, i_ray.maxDistance))) continue;
+					if (node.body >= 0)
+					{
+						RaycastBody(i_ray, queryBodies[node.body], o_hit);
+						continue;
+					}
+					stack[stackSize++] = node.rightChild;
+					stack[stackSize++] = nodeIndex + 1;
+				}
+			}
+
+			int Octant(const Math::sVector& i_direction)
+			{
+				return (i_direction.x < 0.0f ? 1 : 0) | (i_direction.y < 0.0f ? 2 : 0) | (i_direction.z < 0.0f ? 4 : 0);
+			}
+
+			//rays with directions in the same octant walk the tree together, a node is entered if any ray of the packet hits its box
+			void RaycastPacket(const RayQuery* i_rays, int i_count, RayHit* o_hits)
+			{
+				Math::sVector inverse[QUERY_MAX_PACKET];
+				for (int r = 0; r < i_count; r++)
+				{
+					o_hits[r] = RayHit();
+					inverse[r] = Math::sVector(1.0f / i_rays[r].direction.x, 1.0f / i_rays[r].direction.y, 1.0f / i_rays[r].direction.z);
+				}
+				if (queryNodes.empty()) return;
+				int stack[QUERY_STACK_SIZE];
+				int stackSize = 0;
+				stack[stackSize++] = 0;
+				while (stackSize > 0)
+				{
+					int nodeIndex = stack[--stackSize];
+					const QueryNode& node = queryNodes[nodeIndex];
+					unsigned int active = 0;
+					for (int r = 0; r < i_count; r++)
+					{
+						if (RayBoxOverlap(i_rays[r].origin, inverse[r], node.boxMin, node.boxMax, std::min(o_hits[r].distance, i_rays[r].maxDistance))) active |= 1u << r;
+					}
+					if (active == 0) continue;
+					if (node.body >= 0)
+					{
+						for (int r = 0; r < i_count; r++)
+						{
+							if (active & (1u << r)) RaycastBody(i_rays[r], queryBodies[node.body], o_hits[r]);
+						}
+						continue;
+					}
+					stack[stackSize++] = node.rightChild;
+					stack[stackSize++] = nodeIndex + 1;
+				}
+			}
+		}
+
+		void BuildQueryTree(std::vector<GameCommon::GameObject *> & i_colliderObjects)
+		{
+			int n = static_cast<int>(i_colliderObjects.size());
+			queryNodes.clear();
+			queryBodies.resize(n);
+			queryBoxes.resize(n);
+			queryOrder.resize(n);
+			for (int i = 0; i < n; i++)
+			{
+				queryBodies[i] = &i_colliderObjects[i]->m_State;
+				queryBoxes[i] = ComputeWorldAABB(i_colliderObjects[i]->m_State);
+				queryOrder[i] = i;
+			}
+			if (n == 0) return;
+			queryNodes.reserve(static_cast<size_t>(n) * 2);
+			BuildNode(0, n);
+		}
+
+		void RaycastBatch(const RayQuery* i_rays, int i_count, RayHit* o_hits)
+		{
+			int packetSize = std::max(1, std::min(queryPacketSize, QUERY_MAX_PACKET));
+			int numPackets = (i_count + packetSize - 1) / packetSize;
+#pragma omp parallel for schedule(dynamic)
+			for (int p = 0; p < numPackets; p++)
+			{
+				int first = p * packetSize;
+				int count = std::min(packetSize, i_count - first);
+				bool coherent = count > 1;
+				int octant = Octant(i_rays[first].direction);
+				for (int r = first + 1; r < first + count && coherent; r++)
+				{
+					if (Octant(i_rays[r].direction) != octant) coherent = false;
+				}
+				if (coherent)
+				{
+					RaycastPacket(i_rays + first, count, o_hits + first);
+				}
+				else
+				{
+					for (int r = first; r < first + count; r++) RaycastSingle(i_rays[r], o_hits[r]);
+				}
+			}
+		}
+
+		void OverlapBatch(const AABB* i_boxes, int i_count, sRigidBodyState** o_results, int i_maxResults, int* o_counts)
+		{
+#pragma omp parallel for schedule(dynamic)
+			for (int q = 0; q < i_count; q++)
+			{
+				int found = 0;
+				if (!queryNodes.empty())
+				{
+					Math::sVector low = i_boxes[q].center - i_boxes[q].extends, high = i_boxes[q].center + i_boxes[q].extends;
+					int stack[QUERY_STACK_SIZE];
+					int stackSize = 0;
+					stack[stackSize++] = 0;
+					while (stackSize > 0)
+					{
+						int nodeIndex = stack[--stackSize];
+						const QueryNode& node = queryNodes[nodeIndex];
+						if (node.boxMin.x > high.x || node.boxMax.x < low.x || node.boxMin.y > high.y || node.boxMax.y < low.y || node.boxMin.z > high.z || node.boxMax.z < low.z) continue;
+						if (node.body >= 0)
+						{
+							if (found < i_maxResults) o_results[q * i_maxResults + found] = queryBodies[node.body];
+							found++;
+							continue;
+						}
+						stack[stackSize++] = node.rightChild;
+						stack[stackSize++] = nodeIndex + 1;
+					}
+				}
+				o_counts[q] = found;
+			}
+		}
+	}
+}
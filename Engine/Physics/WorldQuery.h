@@ -0,0 +1,36 @@
+#pragma once
+#include <vector>
+#include "CollisionHelpers.h"
+
+namespace sca2025 {
+	namespace GameCommon {
+		class GameObject;
+	}
+
+	namespace Physics {
+		struct sRigidBodyState;
+
+		struct RayQuery {
+			Math::sVector origin;
+			Math::sVector direction;//normalized
+			float maxDistance = FLT_MAX;
+		};
+
+		struct RayHit {
+			sRigidBodyState* pBody = nullptr;//nullptr when the ray hit nothing
+			Math::sVector position;
+			Math::sVector normal;
+			float distance = FLT_MAX;
+		};
+
+		extern int queryPacketSize;//rays traversed together when their directions share an octant, 1 disables packets
+
+		//AABB tree over the world boxes of the collider objects, queries see the world as of the last build
+		void BuildQueryTree(std::vector<GameCommon::GameObject *> & i_colliderObjects);
+		//closest hit of every ray, o_hits needs room for i_count hits
+		void RaycastBatch(const RayQuery* i_rays, int i_count, RayHit* o_hits);
+		//bodies whose world AABB overlaps each query box, query i writes up to i_maxResults bodies from o_results[i * i_maxResults]
+		//o_counts[i] is the number found, which may exceed i_maxResults
+		void OverlapBatch(const AABB* i_boxes, int i_count, sRigidBodyState** o_results, int i_maxResults, int* o_counts);
+	}
+}
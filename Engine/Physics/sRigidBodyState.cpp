@@ -78,6 +78,20 @@ void sca2025::Physics::sRigidBodyState::UpdateOrientation(const float i_secondCo
 	globalInverseInertiaTensor = local2WorldRot * localInverseInertiaTensor * world2LocalRot;
 }
 
+void sca2025::Physics::sRigidBodyState::ApplyImpulse(const Math::sVector& i_impulse, const Math::sVector& i_worldPoint)
+{
+	if (isStatic) return;
+	velocity += i_impulse * (1 / mass);
+	angularVelocity += globalInverseInertiaTensor * Math::Cross(i_worldPoint - position, i_impulse);
+	WakeUp();
+}
+
+void sca2025::Physics::sRigidBodyState::WakeUp()
+{
+	quietTickCount = 0;
+	isSleeping = false;
+}
+
 
 sca2025::Math::sVector sca2025::Physics::sRigidBodyState::PredictFuturePosition( const float i_secondCountToExtrapolate ) const
 {
@@ -57,6 +57,9 @@ namespace sca2025
 			bool isStatic = false;
 			bool hasGravity = false;
 			bool collision = false;
+			//sleeping bodies are skipped by integration, narrowphase and the solver
+			bool isSleeping = false;
+			int quietTickCount = 0;
 			// Interface
 			//==========
 			sRigidBodyState();
@@ -65,6 +68,8 @@ namespace sca2025
 			void UpdatePosition(const float i_secondCountToIntegrate);
 			void UpdateVelocity(const float i_secondCountToIntegrate);
 			void UpdateOrientation(const float i_secondCountToIntegrate);
+			void ApplyImpulse(const Math::sVector& i_impulse, const Math::sVector& i_worldPoint);
+			void WakeUp();
 			Math::sVector PredictFuturePosition( const float i_secondCountToExtrapolate ) const;
 			Math::cQuaternion PredictFutureOrientation( const float i_secondCountToExtrapolate ) const;
 		};
@@ -19,6 +19,7 @@
 #include "Engine/GameCommon/Ground.h"
 #include "Engine/Profiling/Profiling.h"
 #include "Engine/GameCommon/GameplayUtility.h"
+#include "Engine/GameCommon/DebugDraw.h"
 #include "BallJointSim.h"
 #include "MultiBody.h"
 // Inherited Implementation
@@ -53,6 +54,7 @@ sca2025::cResult sca2025::BallJointSim::Initialize()
 	LOAD_MESH("data/meshes/bullet.mesh", mesh_anchor)
 	LOAD_MESH("data/meshes/cube.mesh", mesh_cube)
 	LOAD_MESH("data/meshes/capsule.mesh", mesh_capsule)
+	DebugDraw::lineMesh = mesh_cube;
 
 	{
 		//cbApplication* pApp = this;
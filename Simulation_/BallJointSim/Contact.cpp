@@ -0,0 +1,238 @@
+#include "MultiBody.h"
+#include "Engine/Physics/Broadphase.h"
+#include "Engine/Physics/WorldQuery.h"
+#include "Engine/Physics/sRigidBodyState.h"
+#include <algorithm>
+
+//Contacts between the links and the world, solved in joint space.
+//A contact row maps qdot to the normal velocity of the contact point through the link Jacobian Ht,
+//so the impulse never pulls the joints apart. Contact rows and joint limit rows share one LCP.
+
+#define LINK_MAX_CANDIDATES 16
+
+namespace
+{
+	sca2025::Math::sVector ToNative(const _Vector3& i_v)
+	{
+		return sca2025::Math::sVector(static_cast<float>(i_v(0)), static_cast<float>(i_v(1)), static_cast<float>(i_v(2)));
+	}
+
+	_Vector3 ToEigen(const sca2025::Math::sVector& i_v)
+	{
+		return _Vector3(i_v.x, i_v.y, i_v.z);
+	}
+}
+
+void sca2025::MultiBody::DetectContacts()
+{
+	linkContacts.clear();
+	if (groundContact) DetectGroundContacts();
+	if (worldContact) DetectWorldContacts();
+}
+
+void sca2025::MultiBody::DetectGroundContacts()
+{
+	_Vector3 normal = ToEigen(ground.normal);
+	for (int i = 0; i < numOfLinks; i++)
+	{
+		Physics::HalfSpaceContact proxyContacts[8];
+		int numContacts = 0;
+		Math::sVector center = ToNative(pos[i]);
+		if (geometry == BALL)
+		{
+			numContacts = Physics::CollideSphereHalfSpace(center, static_cast<float>(proxyHalfExtents[i](0)), ground, proxyContacts);
+		}
+		else
+		{
+			Math::sVector axes[3];
+			float extents[3];
+			for (int j = 0; j < 3; j++)
+			{
+				axes[j] = ToNative(R_global[i].col(j));
+				extents[j] = static_cast<float>(proxyHalfExtents[i](j));
+			}
+			numContacts = Physics::CollideBoxHalfSpace(center, axes, extents, ground, proxyContacts);
+		}
+		for (int k = 0; k < numContacts; k++)
+		{
+			sLinkContact contact;
+			contact.link = i;
+			contact.point = ToEigen(proxyContacts[k].position);
+			contact.normal = normal;
+			contact.depth = proxyContacts[k].depth;
+			linkContacts.push_back(contact);
+		}
+	}
+}
+
+void sca2025::MultiBody::UpdateLinkColliders()
+{
+	if (static_cast<int>(linkColliders.size()) != numOfLinks)
+	{
+		linkColliders.clear();
+		for (int i = 0; i < numOfLinks; i++)
+		{
+			if (geometry == BALL)
+			{
+				std::vector<Math::sVector> sphere = { Math::sVector(), Math::sVector(static_cast<float>(proxyHalfExtents[i](0)), 0.0f, 0.0f) };
+				linkColliders.push_back(Physics::Collider(sphere, Sphere));
+			}
+			else
+			{
+				Physics::AABB box;
+				box.extends = ToNative(proxyHalfExtents[i]);
+				Physics::Collider collider;
+				collider.InitializeCollider(box);
+				collider.m_type = Box;
+				linkColliders.push_back(collider);
+			}
+		}
+		//copying a collider does not copy its parent
+		for (int i = 0; i < numOfLinks; i++) linkColliders[i].m_pParentRigidBody = &m_linkBodys[i]->m_State;
+	}
+	for (int i = 0; i < numOfLinks; i++)
+	{
+		Math::cMatrix_transformation rotation;
+		rotation.m_00 = static_cast<float>(R_global[i](0, 0)); rotation.m_01 = static_cast<float>(R_global[i](0, 1)); rotation.m_02 = static_cast<float>(R_global[i](0, 2));
+		rotation.m_10 = static_cast<float>(R_global[i](1, 0)); rotation.m_11 = static_cast<float>(R_global[i](1, 1)); rotation.m_12 = static_cast<float>(R_global[i](1, 2));
+		rotation.m_20 = static_cast<float>(R_global[i](2, 0)); rotation.m_21 = static_cast<float>(R_global[i](2, 1)); rotation.m_22 = static_cast<float>(R_global[i](2, 2));
+		Math::cMatrix_transformation transformation = rotation;
+		transformation.m_03 = static_cast<float>(pos[i](0));
+		transformation.m_13 = static_cast<float>(pos[i](1));
+		transformation.m_23 = static_cast<float>(pos[i](2));
+		linkColliders[i].UpdateTransformation(transformation, rotation);
+	}
+}
+
+sca2025::Physics::AABB sca2025::MultiBody::ComputeLinkAABB(int i)
+{
+	Physics::AABB box;
+	box.center = ToNative(pos[i]);
+	_Vector3 extends;
+	if (geometry == BALL) extends = _Vector3::Constant(proxyHalfExtents[i](0));
+	else extends = R_global[i].cwiseAbs() * proxyHalfExtents[i];
+	box.extends = ToNative(extends) + Math::sVector(Physics::broadphaseMargin, Physics::broadphaseMargin, Physics::broadphaseMargin);
+	return box;
+}
+
+void sca2025::MultiBody::QueryContactCandidates()
+{
+	std::vector<Physics::AABB> boxes(numOfLinks);
+	for (int i = 0; i < numOfLinks; i++) boxes[i] = ComputeLinkAABB(i);
+	contactCandidates.resize(numOfLinks * LINK_MAX_CANDIDATES);
+	contactCandidateCounts.resize(numOfLinks);
+	Physics::OverlapBatch(boxes.data(), numOfLinks, contactCandidates.data(), LINK_MAX_CANDIDATES, contactCandidateCounts.data());
+}
+
+void sca2025::MultiBody::DetectWorldContacts()
+{
+	UpdateLinkColliders();
+	QueryContactCandidates();
+	for (int i = 0; i < numOfLinks; i++)
+	{
+		int numCandidates = std::min(contactCandidateCounts[i], LINK_MAX_CANDIDATES);
+		for (int c = 0; c < numCandidates; c++)
+		{
+			Physics::sRigidBodyState* pBody = contactCandidates[i * LINK_MAX_CANDIDATES + c];
+			Physics::Contact contacts[NARROWPHASE_MAX_CONTACTS];
+			bool fullManifold;
+			Math::sVector searchDir;
+			int numContacts = Physics::Collide(linkColliders[i], pBody->collider, contacts, fullManifold, searchDir);
+			if (numContacts > 0 && !pBody->isStatic && !pBody->isSleeping) WakeUp();
+			for (int k = 0; k < numContacts; k++)
+			{
+				//contact normals point from the link to the obstacle
+				sLinkContact contact;
+				contact.link = i;
+				contact.point = ToEigen(contacts[k].globalPositionA);
+				contact.normal = -ToEigen(contacts[k].normal);
+				contact.depth = contacts[k].depth;
+				linkContacts.push_back(contact);
+			}
+		}
+	}
+}
+
+//an awake dynamic body overlaps a link, the multibody has to stay awake to respond
+bool sca2025::MultiBody::HasDynamicContact()
+{
+	QueryContactCandidates();
+	for (int i = 0; i < numOfLinks; i++)
+	{
+		int numCandidates = std::min(contactCandidateCounts[i], LINK_MAX_CANDIDATES);
+		for (int c = 0; c < numCandidates; c++)
+		{
+			Physics::sRigidBodyState* pBody = contactCandidates[i * LINK_MAX_CANDIDATES + c];
+			if (!pBody->isStatic && !pBody->isSleeping) return true;
+		}
+	}
+	return false;
+}
+
+void sca2025::MultiBody::SolveVelocityLCP(_Vector& i_limitBias, const _Scalar h)
+{
+	int limitNum = static_cast<int>(constraintNum);
+	int contactNum = static_cast<int>(linkContacts.size());
+	int rowNum = limitNum + contactNum;
+	if (rowNum == 0) return;
+
+	//limit rows first, then one row per contact
+	_Matrix J;
+	J.resize(rowNum, totalVelDOF);
+	_Vector bias;
+	bias.resize(rowNum);
+	if (limitNum > 0)
+	{
+		J.topRows(limitNum) = J_constraint;
+		bias.head(limitNum) = i_limitBias;
+	}
+	for (int k = 0; k < contactNum; k++)
+	{
+		sLinkContact& contact = linkContacts[k];
+		int i = contact.link;
+		//normal velocity of the point is n.v + (r x n).w
+		_Vector3 r = contact.point - pos[i];
+		J.row(limitNum + k) = contact.normal.transpose() * Ht[i].topRows(3) + r.cross(contact.normal).transpose() * Ht[i].bottomRows(3);
+		bias(limitNum + k) = -contactBeta / h * std::max<_Scalar>(contact.depth - contactSlop, 0.0);
+	}
+
+	_Matrix MJt = MrInverse * J.transpose();
+	_Matrix T = J * MJt;
+	//each block is regularized by its own largest entry, so the limit rows alone see the same system as without contacts
+	if (limitNum > 0)
+	{
+		_Scalar deltaSquared = abs(T.topLeftCorner(limitNum, limitNum).maxCoeff()) * 1e-6;
+		T.topLeftCorner(limitNum, limitNum) += deltaSquared * _Matrix::Identity(limitNum, limitNum);
+	}
+	if (contactNum > 0)
+	{
+		_Scalar deltaSquared = abs(T.bottomRightCorner(contactNum, contactNum).maxCoeff()) * 1e-6;
+		T.bottomRightCorner(contactNum, contactNum) += deltaSquared * _Matrix::Identity(contactNum, contactNum);
+	}
+	_Vector v = J * qdot;
+
+	//the position solve reuses the effective mass of the limit rows
+	_Vector lambda = _Vector::Zero(rowNum);
+	if (limitNum > 0)
+	{
+		effectiveMass0 = T.topLeftCorner(limitNum, limitNum).inverse();
+		lambda.head(limitNum) = (effectiveMass0 * (-v.head(limitNum) - i_limitBias)).cwiseMax(0.0);
+	}
+	//without contacts the clamped direct solve is the answer, contacts couple the rows and are iterated
+	if (contactNum > 0)
+	{
+		for (int iteration = 0; iteration < contactIterations; iteration++)
+		{
+			for (int k = 0; k < rowNum; k++)
+			{
+				_Scalar residual = v(k) + T.row(k).dot(lambda);
+				lambda(k) = std::max<_Scalar>(lambda(k) - (residual + bias(k)) / T(k, k), 0.0);
+			}
+		}
+	}
+	for (int k = 0; k < limitNum; k++)
+	{
+		maxLimitImpulse = std::max<_Scalar>(maxLimitImpulse, lambda(k));
+	}
+	qdot = qdot + MJt * lambda;
+}
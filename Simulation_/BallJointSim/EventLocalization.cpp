@@ -0,0 +1,53 @@
+#include "MultiBody.h"
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <algorithm>
+
+//Event localized stepping. When the predicted beta of an Euler twist constraint crosses +-pi/2 during a step,
+//the crossing time is found by bisection and the step is split there, so the vector field switches exactly at the event.
+
+void sca2025::MultiBody::EventLocalizedStep(const _Scalar h)
+{
+	if (!eventLocalization || constraintSolverMode == PBD)
+	{
+		IntegrateStep(h);
+		return;
+	}
+
+	//only a sign change inside the step is an event, a limit that starts past the boundary is left to the switch
+	_Scalar eventStart = ComputeEventFunction();
+	SaveStepSnapshot(eventSnapshot);
+	IntegrateStep(h);
+	if (eventStart > 0 || ComputeEventFunction() <= 0) return;
+
+	//the event is bracketed by [lo, hi] as fractions of the step
+	_Scalar lo = 0;
+	_Scalar hi = 1;
+	for (int k = 0; k < eventMaxIterations && (hi - lo) * h > eventTimeTolerance; k++)
+	{
+		_Scalar mid = 0.5 * (lo + hi);
+		RestoreStepSnapshot(eventSnapshot);
+		IntegrateStep(mid * h);
+		if (ComputeEventFunction() > 0) hi = mid;
+		else lo = mid;
+	}
+
+	//land just after the event, the next part of the step starts with the switched vector field
+	RestoreStepSnapshot(eventSnapshot);
+	IntegrateStep(hi * h);
+	eventSplitCount++;
+	if (hi < 1) IntegrateStep((1 - hi) * h);
+}
+
+_Scalar sca2025::MultiBody::ComputeEventFunction()
+{
+	//positive once the predicted beta of any Euler twist constraint is past +-pi/2
+	_Scalar out = -1;
+	if (twistMode != EULER && twistMode != EULER_V2) return out;
+	for (int i = 0; i < numOfLinks; i++)
+	{
+		if (!IsLimitActive(i) || jointType[i] != BALL_JOINT_4D || jointRange[i].second <= 0) continue;
+		out = std::max<_Scalar>(out, abs(PredictBeta(i)) - 0.5 * M_PI);
+	}
+	return out;
+}
@@ -28,25 +28,29 @@ _Scalar sca2025::MultiBody::ComputeSwingError(int jointNum)
 	return out;
 }
 
+_Scalar sca2025::MultiBody::PredictBeta(int i)
+{
+	//continue beta from the last valid orientation, unlike the Euler decomposition it is not folded back at +-pi/2
+	_Quat oriDiff = rel_ori[i] * lastValidOri[i].inverse();
+	_Vector3 deltaRot;
+	deltaRot = Math::RotationConversion_QuatToVec(oriDiff);
+	deltaRot = Math::RotationConversion_QuatToMat(eulerDecompositionOffset[i]) * deltaRot;
+
+	_Scalar eulerAngles[3];
+	GetEulerAngles(i, lastValidOri[i], eulerAngles);
+	_Scalar oldAlpha = eulerAngles[2];
+	_Scalar oldBeta = eulerAngles[1];
+	_Vector3 K(sin(oldAlpha), 0, cos(oldAlpha));
+	return oldBeta + K.dot(deltaRot);
+}
+
 void sca2025::MultiBody::SwitchConstraint(int i)
 {
 	_Scalar eulerEpsilon = 1e-6;
 	if (M_PI * 0.5 - abs(mBeta[i]) > eulerEpsilon)
 	{
 		//check if switch is required
-		_Quat oriDiff = rel_ori[i] * lastValidOri[i].inverse();
-		_Vector3 deltaRot;
-		deltaRot = Math::RotationConversion_QuatToVec(oriDiff);
-		deltaRot = Math::RotationConversion_QuatToMat(eulerDecompositionOffset[i]) * deltaRot;
-		
-		_Scalar eulerAngles[3];
-		GetEulerAngles(i, lastValidOri[i], eulerAngles);
-		_Scalar oldAlpha = eulerAngles[2];
-		_Scalar oldBeta = eulerAngles[1];
-		_Scalar betaDiff;
-		_Vector3 K(sin(oldAlpha), 0, cos(oldAlpha));
-		betaDiff = K.dot(deltaRot);
-		_Scalar newBeta = oldBeta + betaDiff;
+		_Scalar newBeta = PredictBeta(i);
 		//std::cout << "---quat " << rel_ori[i] << std::endl;
 		//std::cout << "----alpha " << mAlpha[i] << " beta " << mBeta[i] << " prediced beta: " << newBeta << std::endl;
 		
@@ -92,7 +96,7 @@ _Scalar sca2025::MultiBody::ComputeTwistEulerError(int jointNum)
 		if (sNorm < dtEpsilon)
 		{
 			_Scalar newDt = 0.0001;
-			pApp->UpdateDeltaTime(newDt);
+			adaptiveStepSize = newDt;
 			std::cout << "Finner dt is used " << newDt << std::endl;
 		}
 	}
@@ -109,6 +113,12 @@ void sca2025::MultiBody::BallJointLimitCheck()
 
 	for (int i = 0; i < numOfLinks; i++)
 	{
+		if (!IsLimitActive(i))
+		{
+			//the vector field keeps following dropped limits so it is valid when they come back, only the rows are skipped
+			if (jointType[i] == BALL_JOINT_4D && jointRange[i].second > 0 && (twistMode == EULER || twistMode == EULER_V2)) SwitchConstraint(i);
+			continue;
+		}
 		if (jointType[i] == BALL_JOINT_4D)
 		{
 			_Quat quat = Math::RotationConversion_MatToQuat(R_local[i]);
@@ -303,12 +313,12 @@ void sca2025::MultiBody::ComputeTwistDirectJacobian(int jointNum, int i_limitTyp
 
 void sca2025::MultiBody::SolveVelocityJointLimit(const _Scalar h)
 {
+	J_constraint.resize(constraintNum, totalVelDOF);
+	_Vector bias;
+	bias.resize(constraintNum);
 	if (constraintNum > 0)
 	{
-		J_constraint.resize(constraintNum, totalVelDOF);
 		J_constraint.setZero();
-		_Vector bias;
-		bias.resize(constraintNum);
 		bias.setZero();
 		for (size_t k = 0; k < constraintNum; k++)
 		{
@@ -374,25 +384,9 @@ void sca2025::MultiBody::SolveVelocityJointLimit(const _Scalar h)
 			_Scalar CR = 0;
 			bias(k) = -CR * std::max<_Scalar>(-C_dot(0, 0), 0.0);
 		}
-		_Matrix lambda;
-		_Matrix T;
-		_Matrix mIdentity;
-		mIdentity = _Matrix::Identity(constraintNum, constraintNum);
-		
-		T = J_constraint * MrInverse * J_constraint.transpose();
-		_Scalar deltaSquared = abs(T.maxCoeff()) * 1e-6;
-		effectiveMass0 = (T + deltaSquared * mIdentity).inverse();
-		lambda = effectiveMass0 * (-J_constraint * qdot - bias);
-		for (size_t k = 0; k < constraintNum; k++)
-		{
-			if (lambda(k, 0) < 0)
-			{
-				lambda(k, 0) = 0;
-			}
-		}
-		_Vector qdotCorrection = MrInverse * J_constraint.transpose() * lambda;
-		qdot = qdot + qdotCorrection;
 	}
+	//contacts join the limit rows in one LCP
+	SolveVelocityLCP(bias, h);
 }
 
 void sca2025::MultiBody::SolvePositionJointLimit()
@@ -0,0 +1,81 @@
+#include "MultiBody.h"
+#include "Engine/Math/EigenHelper.h"
+#include <algorithm>
+
+//Level of detail per multibody instance.
+//LOD_MERGED welds leaf links to their parents and drops non-critical joint limits,
+//LOD_COARSE additionally multiplies the step interval of the multi-rate scheduler by lodStepInterval.
+//For the reduced coordinate solvers a welded joint has no velocity DOF, the leaf rides on its parent and its inertia is fused
+//into the parent's, so Ht, Mr and qdot only span the remaining joints. XPBD keeps every joint and welds leaves with a constraint.
+
+void sca2025::MultiBody::UpdateLODLevel()
+{
+	if (!m_importance) return;
+
+	_Scalar importance = m_importance();
+	int level = LOD_FULL;
+	if (importance < lodLowImportance) level = LOD_COARSE;
+	else if (importance < lodMediumImportance) level = LOD_MERGED;
+	SetLODLevel(level);
+}
+
+void sca2025::MultiBody::SetLODLevel(int level)
+{
+	if (level == lodLevel) return;
+
+	ResetStepSchedule();
+	lodLevel = level;
+
+	for (int i = 0; i < numOfLinks; i++)
+	{
+		bool isLeaf = parentArr[i] != -1 && std::find(parentArr.begin(), parentArr.end(), i) == parentArr.end();
+		lodLocked[i] = level > LOD_FULL && isLeaf && jointType[i] != FREE_JOINT;
+		if (lodLocked[i])
+		{
+			lodLockedOri[i] = Math::RotationConversion_MatToQuat(R_local[i]);
+		}
+	}
+
+	if (constraintSolverMode != PBD) UpdateVelocityLayout();
+}
+
+void sca2025::MultiBody::UpdateVelocityLayout()
+{
+	//spatial velocities of the links before the switch
+	std::vector<_Vector> V(numOfLinks);
+	for (int i = 0; i < numOfLinks; i++)
+	{
+		V[i] = Ht[i] * qdot;
+	}
+
+	totalVelDOF = 0;
+	for (int i = 0; i < numOfLinks; i++)
+	{
+		lodWeldedChildren[i].clear();
+	}
+	for (int i = 0; i < numOfLinks; i++)
+	{
+		velDOF[i] = lodLocked[i] ? 0 : jointVelDOF[i];
+		velStartIndex[i] = totalVelDOF;
+		totalVelDOF += velDOF[i];
+		if (lodLocked[i]) lodWeldedChildren[parentArr[i]].push_back(i);
+	}
+	Mr.resize(totalVelDOF, totalVelDOF);
+	qdot = _Vector::Zero(totalVelDOF);
+	Forward();
+
+	//welded joints lose their relative velocity, the mass weighted fit keeps the generalized momentum of the remaining joints
+	_Vector p = _Vector::Zero(totalVelDOF);
+	for (int i = 0; i < numOfLinks; i++)
+	{
+		p += Ht[i].transpose() * Mbody[i] * V[i];
+	}
+	qdot = MrInverse * p;
+	ForwardAngularAndTranslationalVelocity(qdot);
+}
+
+bool sca2025::MultiBody::IsLimitActive(int i)
+{
+	if (lodLevel == LOD_FULL) return true;
+	return !lodLocked[i] && criticalLimit[i];
+}
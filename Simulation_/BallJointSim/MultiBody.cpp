@@ -53,6 +53,11 @@ void sca2025::MultiBody::MultiBodyInitialization()
 	lastValidOri.resize(numOfLinks);
 	eulerDecompositionOffsetMat.resize(numOfLinks);
 	totalTwist.resize(numOfLinks);
+	lodLocked.assign(numOfLinks, false);
+	lodWeldedChildren.resize(numOfLinks);
+	jointVelDOF = velDOF;
+	criticalLimit.assign(numOfLinks, true);
+	lodLockedOri.resize(numOfLinks);
 	externalForces.resize(numOfLinks);
 	for (int i = 0; i < numOfLinks; i++)
 	{
@@ -132,7 +137,6 @@ void sca2025::MultiBody::ConfigureSingleBallJoint(int bodyNum, _Vector3& xAxis,
 
 void sca2025::MultiBody::Tick(const double i_secondCountToIntegrate)
 {	
-	if (adaptiveTimestep) pApp->UpdateDeltaTime(pApp->GetSimulationUpdatePeriod_inSeconds());
 	dt = (_Scalar)i_secondCountToIntegrate;
 	tickCountSimulated++;
 	/*{
@@ -147,21 +151,65 @@ void sca2025::MultiBody::Tick(const double i_secondCountToIntegrate)
 	
 	ResetExternalForces();
 	if(m_control) m_control();
-	if (integrationMethod == EXPLICIT)
+	//only control has written the forces so far, stepping adds gravity to them
+	bool externalActivity = HasExternalActivity();
+	if (isSleeping)
 	{
-		EulerIntegration(dt);
+		if (!externalActivity) return;
+		WakeUp();
 	}
-	else if (integrationMethod == RK4)
+	UpdateLODLevel();
+	maxLimitImpulse = 0;
+	ScheduleSteps(dt);
+	if (sleepTickWindow > 0) UpdateSleepState(externalActivity);
+}
+
+bool sca2025::MultiBody::HasExternalActivity()
+{
+	for (int i = 0; i < numOfLinks; i++)
+	{
+		if (externalForces[i].cwiseAbs().maxCoeff() > wakeForceThreshold) return true;
+	}
+	if (worldContact && HasDynamicContact()) return true;
+	//velocities written directly by m_control
+	return qdot.size() > 0 && 0.5 * qdot.dot(Mr * qdot) > sleepEnergyThreshold;
+}
+
+void sca2025::MultiBody::UpdateSleepState(bool i_externalActivity)
+{
+	if (ComputeKineticEnergy() < sleepEnergyThreshold && maxLimitImpulse < sleepImpulseThreshold && !i_externalActivity)
+	{
+		quietTickCount++;
+	}
+	else
+	{
+		quietTickCount = 0;
+	}
+	if (quietTickCount < sleepTickWindow) return;
+
+	isSleeping = true;
+	qdot.setZero();
+	for (int i = 0; i < numOfLinks; i++)
 	{
-		RK4Integration(dt);
+		vel[i].setZero();
+		w_abs_world[i].setZero();
+		w_rel_world[i].setZero();
+		w_rel_local[i].setZero();
 	}
 }
 
+void sca2025::MultiBody::WakeUp()
+{
+	quietTickCount = 0;
+	if (!isSleeping) return;
+	isSleeping = false;
+}
+
 void sca2025::MultiBody::ClampRotationVector()
 {
 	for (int i = 0; i < numOfLinks; i++)
 	{
-		if (jointType[i] == BALL_JOINT_3D)
+		if (jointType[i] == BALL_JOINT_3D && velDOF[i] > 0)
 		{
 			_Vector3 r = q.segment(posStartIndex[i], 3);
 			_Scalar theta = r.norm();
@@ -186,7 +234,13 @@ void sca2025::MultiBody::Integrate_q(_Vector& o_q, std::vector<_Quat>& o_quat, _
 {
 	for (int i = 0; i < numOfLinks; i++)
 	{
-		if (jointType[i] == BALL_JOINT_3D)
+		if (velDOF[i] == 0)
+		{
+			//welded joints keep their relative orientation
+			o_q.segment(posStartIndex[i], posDOF[i]) = i_q.segment(posStartIndex[i], posDOF[i]);
+			o_quat[i] = i_quat[i];
+		}
+		else if (jointType[i] == BALL_JOINT_3D)
 		{
 			o_q.segment(posStartIndex[i], 3) = i_q.segment(posStartIndex[i], 3) + i_qdot.segment(velStartIndex[i], 3) * h;
 		}
@@ -218,6 +272,7 @@ void sca2025::MultiBody::EulerIntegration(const _Scalar h)
 	if (constraintSolverMode == IMPULSE)
 	{
 		BallJointLimitCheck();
+		DetectContacts();
 		SolveVelocityJointLimit(h);
 	}
 	
@@ -243,6 +298,7 @@ void sca2025::MultiBody::RK4Integration(const _Scalar h)
 	if (constraintSolverMode == IMPULSE)
 	{
 		BallJointLimitCheck();
+		DetectContacts();
 		SolveVelocityJointLimit(h);
 	}
 
@@ -332,6 +388,12 @@ void sca2025::MultiBody::ComputeHt(_Vector& i_q, std::vector<_Quat>& i_quat)
 		}
 		//compose Ht
 		Ht[i].resize(6, totalVelDOF);
+		if (velDOF[i] == 0)
+		{
+			//welded leaf, moves rigidly with its parent
+			Ht[i] = D[i] * Ht[j];
+			continue;
+		}
 		Ht[i].setZero();
 		int k = i;
 		while (k != -1)
@@ -356,7 +418,15 @@ void sca2025::MultiBody::ComputeMr()
 	Mr.setZero();
 	for (int i = 0; i < numOfLinks; i++)
 	{
-		_Matrix M_temp = Ht[i].transpose() * Mbody[i] * Ht[i];
+		if (velDOF[i] == 0) continue;
+		//welded leaves share the spatial velocity of their parent, D^T M D is their inertia at the parent
+		_Matrix M_fused = Mbody[i];
+		for (size_t c = 0; c < lodWeldedChildren[i].size(); c++)
+		{
+			int k = lodWeldedChildren[i][c];
+			M_fused += D[k].transpose() * Mbody[k] * D[k];
+		}
+		_Matrix M_temp = Ht[i].transpose() * M_fused * Ht[i];
 		Mr = Mr + M_temp;
 	}
 	if (Mr.determinant() < 0.0000001)
@@ -409,7 +479,7 @@ void sca2025::MultiBody::ComputeGamma_t(std::vector<_Vector>& o_gamma_t, _Vector
 		int j = parentArr[i];
 		if (jointType[i] == BALL_JOINT_4D)
 		{
-			_Vector3 r_dot = i_qdot.segment(velStartIndex[i], 3);
+			_Vector3 r_dot = velDOF[i] == 0 ? _Vector3::Zero() : _Vector3(i_qdot.segment(velStartIndex[i], 3));
 			_Vector3 gamma_theta;
 			gamma_theta.setZero();
 			if (i > 0)
@@ -432,7 +502,7 @@ void sca2025::MultiBody::ComputeGamma_t(std::vector<_Vector>& o_gamma_t, _Vector
 		else if (jointType[i] == BALL_JOINT_3D)
 		{
 			_Vector3 r = q.segment(posStartIndex[i], 3);
-			_Vector3 r_dot = i_qdot.segment(velStartIndex[i], 3);
+			_Vector3 r_dot = velDOF[i] == 0 ? _Vector3::Zero() : _Vector3(i_qdot.segment(velStartIndex[i], 3));
 			_Scalar theta = r.norm();
 			_Scalar b = Compute_b(theta);
 			_Scalar a = Compute_a(theta);
@@ -473,7 +543,7 @@ void sca2025::MultiBody::ComputeGamma_t(std::vector<_Vector>& o_gamma_t, _Vector
 		{
 			_Vector3 gamma_theta;
 			gamma_theta.setZero();
-			if (i > 0)
+			if (i > 0 && velDOF[i] > 0)
 			{
 				gamma_theta += Math::ToSkewSymmetricMatrix(w_abs_world[j]) * hingeDirGlobals[i] * i_qdot(velStartIndex[i]);
 			}
@@ -744,9 +814,10 @@ void sca2025::MultiBody::SetHingeJoint(int jointNum, _Vector3 hingeDirLocal, _Sc
 void sca2025::MultiBody::AddRigidBody(int parent, int i_jointType, _Vector3 jointPositionChild, _Vector3 jointPositionParent, Assets::cHandle<Mesh> i_mesh, Vector3d i_meshScale, _Matrix3& i_localInertiaTensor)
 {
 	//initialize body
-	GameCommon::GameObject *pGameObject = new GameCommon::GameObject(defaultEffect, i_mesh, Physics::sRigidBodyState());
+	GameCommon::GameObject *pGameObject = GameCommon::gameObjectPool.Get(GameCommon::gameObjectPool.Create(defaultEffect, i_mesh, Physics::sRigidBodyState()));
 	pGameObject->scale = i_meshScale;
 	m_linkBodys.push_back(pGameObject);
+	proxyHalfExtents.push_back(i_meshScale.cast<_Scalar>());//meshes span -1 to 1
 	localInertiaTensors.push_back(i_localInertiaTensor);
 	_Matrix M_d;
 	M_d.resize(6, 6);
@@ -1,11 +1,12 @@
 #pragma once
-#include "Engine/GameCommon/GameObject.h"
+#include "Engine/GameCommon/GameObjectPool.h"
 #include "Engine/Application/cbApplication.h"
 #include "External/EigenLibrary/Eigen/Dense"
 #include "External/EigenLibrary/Eigen/Geometry"
 #include "MultiBodyTypeDefine.h"
 #include "Engine/Math/DataTypeDefine.h"
 #include "Engine/Math/3DMathHelpers.h"
+#include "Engine/Physics/Narrowphase.h"
 
 namespace sca2025
 {
@@ -15,6 +16,10 @@ namespace sca2025
 		MultiBody(Effect * i_pEffect, Assets::cHandle<Mesh> i_Mesh, Physics::sRigidBodyState i_State, Application::cbApplication* i_application);
 		void Tick(const double i_secondCountToIntegrate) override;
 		void UpdateGameObjectBasedOnInput() override;
+		void WakeUp();//call this on contact or when applying an impulse from outside of m_control
+		bool IsSleeping() { return isSleeping; }
+		void SetLODLevel(int level);
+		int GetLODLevel() { return lodLevel; }
 
 		_Scalar damping = 1.0;
 		int constraintSolverMode = IMPULSE;
@@ -24,6 +29,33 @@ namespace sca2025
 		bool gravity = false ;
 		bool enablePositionSolve = true;
 		bool adaptiveTimestep = false;
+		_Scalar stepSize = 0;//per-object step size in seconds, 0 steps once per application tick
+		int rollbackSubsteps = 0;//substeps used to redo a rejected step, 0 or 1 disables rollback
+		int rollbackMaxRetries = 2;//each retry multiplies the substeps by rollbackSubsteps
+		_Scalar rollbackSingularityEpsilon = 0.005;//sNorm of the Euler twist constraint below which a step is redone
+		_Scalar rollbackErrorThreshold = -1;//joint limit violation above which a step is redone, negative disables
+		bool eventLocalization = false;//split steps at the beta +-pi/2 crossing of Euler twist constraints
+		int eventMaxIterations = 20;
+		_Scalar eventTimeTolerance = 1e-7;
+		int eventSplitCount = 0;//steps split at an event so far
+		int xpbdSubsteps = 20;
+		int xpbdParallelThreshold = 16;//minimum joints in a batch to solve it in parallel
+		_Scalar jointCompliance = 0;//inverse stiffness of ball and hinge connections
+		_Scalar limitCompliance = 0;//inverse stiffness of swing and twist limits
+		int sleepTickWindow = 0;//number of quiet ticks before the multibody falls asleep, 0 disables sleeping
+		_Scalar sleepEnergyThreshold = 1e-6;
+		_Scalar sleepImpulseThreshold = 1e-6;
+		_Scalar wakeForceThreshold = 1e-6;
+		std::function<_Scalar()> m_importance;//user importance metric, drives the LOD level when set
+		_Scalar lodMediumImportance = 0.5;//below this importance LOD_MERGED is used
+		_Scalar lodLowImportance = 0.1;//below this importance LOD_COARSE is used
+		int lodStepInterval = 4;//ticks per step in LOD_COARSE
+		bool groundContact = false;//collide the link proxies with the ground half-space
+		bool worldContact = false;//collide the link proxies with the colliders of Engine/Physics, which are not pushed back
+		Physics::HalfSpace ground = { Math::sVector(0.0f, 1.0f, 0.0f), -10.0f };//matches the ground plane of the scene
+		_Scalar contactBeta = 0.2;//fraction of the penetration removed per step
+		_Scalar contactSlop = 0.01;
+		int contactIterations = 10;//projected Gauss-Seidel sweeps once contacts are present
 		Application::cbApplication* pApp = nullptr;
 	private:
 		void MultiBodyInitialization();
@@ -66,7 +98,64 @@ namespace sca2025
 		void ComputeTwistDirectJacobian(int jointNum, int i_limitType, _Matrix& o_J);
 		void ComputeSwingJacobian(int jointNum, _Matrix& o_J);
 		void SwitchConstraint(int i);
+		_Scalar PredictBeta(int i);
 		void UpdateInitialPosition();//call this function whenever poistion is updated
+
+		void XPBDInitialization();
+		void XPBDIntegration(const _Scalar h);
+		void XPBDSolveJoint(int i, _Scalar h);
+		bool XPBDLimitAngle(_Vector3& n, _Vector3& a, _Vector3& b, _Scalar minAngle, _Scalar maxAngle, _Vector3& o_corr);
+		_Scalar XPBDGeneralizedInverseMass(int body, _Vector3& n, _Vector3* r);
+		void XPBDApplyBodyCorrection(int body, _Vector3& p, _Vector3* r);
+		void XPBDApplyPositionalCorrection(int b0, int b1, _Vector3& i_corr, _Vector3& r0, _Vector3& r1, _Scalar i_compliance, _Scalar& io_lambda, _Scalar h);
+		void XPBDApplyAngularCorrection(int b0, int b1, _Vector3& i_corr, _Scalar i_compliance, _Scalar& io_lambda, _Scalar h);
+		void XPBDSyncReducedCoordinates();
+
+		void StepDynamics(const _Scalar h);
+		void IntegrateStep(const _Scalar h);
+		void ScheduleSteps(const _Scalar i_tickDt);
+		void ResetStepSchedule();
+		void AccumulateControlImpulse(const std::vector<_Vector>& i_forces, const _Scalar i_dt);
+		void ApplyControlImpulse(const _Scalar i_stepDt);
+		void SnapshotRenderState(std::vector<_Vector3>& o_pos, std::vector<_Quat>& o_ori);
+		void InterpolateRenderState(_Scalar t);
+		bool HasExternalActivity();
+		void UpdateSleepState(bool i_externalActivity);
+
+		void UpdateLODLevel();
+		bool IsLimitActive(int i);
+		void UpdateVelocityLayout();
+
+		void DetectContacts();
+		void DetectGroundContacts();
+		void DetectWorldContacts();
+		void UpdateLinkColliders();
+		Physics::AABB ComputeLinkAABB(int i);
+		void QueryContactCandidates();
+		bool HasDynamicContact();
+		void SolveVelocityLCP(_Vector& i_limitBias, const _Scalar h);
+
+		struct sStepSnapshot
+		{
+			_Vector q;
+			_Vector qdot;
+			std::vector<_Quat> rel_ori;
+			std::vector<_Quat> lastValidOri;
+			std::vector<uint16_t> vectorFieldNum;
+			std::vector<_Scalar> totalTwist;
+			_Scalar adaptiveStepSize;
+			_Scalar maxLimitImpulse;
+			//maximal coordinates, only saved for XPBD
+			std::vector<_Vector3> pos;
+			std::vector<_Quat> obs_ori;
+			std::vector<_Vector3> vel;
+			std::vector<_Vector3> w_abs_world;
+		};
+		bool StepNeedsRetry();
+		void SaveStepSnapshot(sStepSnapshot& o_snapshot);
+		void RestoreStepSnapshot(sStepSnapshot& i_snapshot);
+		void EventLocalizedStep(const _Scalar h);
+		_Scalar ComputeEventFunction();
 		
 		//unit tests
 		void UnitTest5_1();//section 5.1 in the paper
@@ -90,7 +179,8 @@ namespace sca2025
 		_Vector qdot;
 		std::vector<int> jointType;
 		std::vector<int> posDOF;
-		std::vector<int> velDOF;
+		std::vector<int> velDOF;//0 for joints welded by LOD
+		std::vector<int> jointVelDOF;//velocity DOF of every joint type
 		std::vector<int> posStartIndex;
 		std::vector<int> velStartIndex;
 		std::vector<int> parentArr;
@@ -151,6 +241,59 @@ namespace sca2025
 
 		std::vector<_Scalar> totalTwist;
 
+		//XPBD
+		std::vector<_Vector3> xpbdPrevPos;
+		std::vector<_Quat> xpbdPrevOri;
+		std::vector<_Matrix3> invLocalInertiaTensors;
+		std::vector<std::vector<int>> xpbdBatches;//joints grouped by color, no two joints in a batch share a body
+		std::vector<_Scalar> xpbdLambda;//connection, swing (or hinge alignment), twist
+		bool xpbdInitialized = false;
+
+		//sleeping
+		bool isSleeping = false;
+		int quietTickCount = 0;
+		_Scalar maxLimitImpulse = 0;//largest joint limit impulse of the current tick
+
+		//level of detail
+		int lodLevel = LOD_FULL;
+		std::vector<bool> lodLocked;//leaf joints welded in LOD_MERGED and LOD_COARSE
+		std::vector<bool> criticalLimit;//non-critical limits are dropped above LOD_FULL
+		std::vector<_Quat> lodLockedOri;
+		std::vector<std::vector<int>> lodWeldedChildren;//welded leaves of every link, their inertia is fused into the link
+
+		//contacts, every link collides through a box (or sphere for BALL geometry) proxy
+		struct sLinkContact
+		{
+			int link;
+			_Vector3 point;//on the link in world space
+			_Vector3 normal;//points away from the obstacle
+			_Scalar depth;
+		};
+		std::vector<_Vector3> proxyHalfExtents;
+		std::vector<Physics::Collider> linkColliders;
+		std::vector<sLinkContact> linkContacts;
+		std::vector<Physics::sRigidBodyState*> contactCandidates;
+		std::vector<int> contactCandidateCounts;
+
+		//multi-rate stepping
+		_Scalar adaptiveStepSize = 0;//finer step requested near singularities for the next tick
+		int stepInterval = 1;//application ticks per step
+		int pendingTickCount = 0;
+		_Scalar pendingTime = 0;
+		std::vector<_Vector> tickForces;//control forces of the current tick
+		std::vector<_Vector> controlImpulses;//control impulses of the ticks not stepped yet
+		std::vector<_Vector> stepForces;//constant control forces over the steps of the current interval
+		std::vector<_Vector3> renderPosPrev;
+		std::vector<_Vector3> renderPosCurr;
+		std::vector<_Quat> renderOriPrev;
+		std::vector<_Quat> renderOriCurr;
+
+		//rollback
+		sStepSnapshot stepSnapshot;
+		sStepSnapshot eventSnapshot;
+		int rollbackCount = 0;
+		int rollbackFailCount = 0;//steps whose finest retry was still rejected
+
 		_Scalar kineticEnergy0 = 0;
 		_Scalar totalEnergy0 = 0;
 		_Vector3 angularMomentum0;
@@ -178,7 +321,6 @@ namespace sca2025
 		//debug related parameters
 		GameObject* swingArrow = nullptr;
 		GameObject* twistArrow = nullptr;
-		GameObject* xArrow = nullptr;
 		GameObject* yArrow = nullptr;
 		GameObject* zArrow = nullptr;
 /*******************************************************************************************/
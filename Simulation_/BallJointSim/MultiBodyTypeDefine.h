@@ -100,4 +100,16 @@
 
 #ifndef RK4
 #define RK4 1
+#endif
+/*************************************/
+#ifndef LOD_FULL
+#define LOD_FULL 0
+#endif
+
+#ifndef LOD_MERGED //leaf links welded to their parents, non-critical limits dropped
+#define LOD_MERGED 1
+#endif
+
+#ifndef LOD_COARSE //LOD_MERGED stepped at a coarser rate
+#define LOD_COARSE 2
 #endif
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "Engine/Math/EigenHelper.h"
 #include "Engine/UserInput/UserInput.h"
 #include "Engine/GameCommon/GameplayUtility.h"
+#include "Engine/GameCommon/DebugDraw.h"
 #include "Engine/GameCommon/Camera.h"
 #define _USE_MATH_DEFINES
 #include <math.h>
@@ -212,6 +213,9 @@ void sca2025::MultiBody::UnitTest5_8a()
 	ConfigureSingleBallJoint(12, _Vector3(1, 0, 0), _Vector3(0, 1, 0), 0.5 * M_PI, 0.1); //right_arm0
 	ConfigureSingleBallJoint(13, _Vector3(0, 1, 0), _Vector3(0, 0, 1), 1e-3, 1e-3); //right_arm1
 	ConfigureSingleBallJoint(14, _Vector3(0, 0, 1), _Vector3(0, 1, 0), 1e-3, 0.5 * M_PI); //right_hand
+	//shoulder limits are dropped at lower LOD
+	criticalLimit[9] = false;
+	criticalLimit[12] = false;
 
 	m_HoudiniSave = [this](int frames_number)
 	{
@@ -377,13 +381,8 @@ void sca2025::MultiBody::UnitTest5_3a()
 		target(2) = 1.9;
 		target(0) = r * sin(Physics::totalSimulationTime * 0.1);
 		target(1) = -r * cos(Physics::totalSimulationTime * 0.1);
-		if (xArrow != nullptr)
-		{
-			xArrow->DestroyGameObject();
-			xArrow = nullptr;
-		}
 		_Vector3 endPoint(0, 0, 1.9);
-		xArrow = GameplayUtility::DrawArrowScaled(endPoint, target - endPoint, Math::sVector(0, 0, 1), Vector3d(0.5, 0.5, 0.5));
+		DebugDraw::DrawArrow(endPoint, target - endPoint, Math::sVector(0, 0, 1), Vector3d(0.5, 0.5, 0.5));
 
 		_Vector3 endFactor(0, -2, 0);
 		endFactor = R_local[0] * endFactor;
@@ -432,13 +431,8 @@ void sca2025::MultiBody::UnitTest5_3b()
 		target(1) = 1.9;
 		target(0) = r * sin(Physics::totalSimulationTime * 0.1);
 		target(2) = r * cos(Physics::totalSimulationTime * 0.1);
-		if (xArrow != nullptr)
-		{
-			xArrow->DestroyGameObject();
-			xArrow = nullptr;
-		}
 		_Vector3 endPoint(0, 1.9, 0);
-		xArrow = GameplayUtility::DrawArrowScaled(endPoint, target - endPoint, Math::sVector(0, 0, 1), Vector3d(0.5, 0.5, 0.5));
+		DebugDraw::DrawArrow(endPoint, target - endPoint, Math::sVector(0, 0, 1), Vector3d(0.5, 0.5, 0.5));
 
 		_Vector3 endFactor(0, -2, 0);
 		endFactor = R_local[0] * endFactor;
@@ -627,5 +621,60 @@ void sca2025::MultiBody::RunUnitTest()
 		twistMode = DIRECT;
 		std::cout << "limitation of position based twist constraint" << std::endl;
 	}
+
+	Application::AddApplicationParameter(&constraintSolverMode, Application::ApplicationParameterType::integer, L"-solver");
+	if (constraintSolverMode == PBD)
+	{
+		Application::AddApplicationParameter(&xpbdSubsteps, Application::ApplicationParameterType::integer, L"-substeps");
+		Application::AddApplicationParameter(&jointCompliance, Application::ApplicationParameterType::float_point, L"-jc");
+		Application::AddApplicationParameter(&limitCompliance, Application::ApplicationParameterType::float_point, L"-lc");
+		std::cout << "XPBD solver is being used with " << xpbdSubsteps << " substeps" << std::endl;
+	}
+
+	Application::AddApplicationParameter(&stepSize, Application::ApplicationParameterType::float_point, L"-dt");
+	if (stepSize > 0)
+	{
+		std::cout << "multibody step size " << stepSize << std::endl;
+	}
+
+	Application::AddApplicationParameter(&rollbackSubsteps, Application::ApplicationParameterType::integer, L"-rollback");
+	if (rollbackSubsteps > 1)
+	{
+		std::cout << "rollback enabled, rejected steps are redone with " << rollbackSubsteps << " substeps" << std::endl;
+	}
+
+	int event = 0;
+	Application::AddApplicationParameter(&event, Application::ApplicationParameterType::integer, L"-event");
+	eventLocalization = event != 0;
+	if (eventLocalization)
+	{
+		std::cout << "steps are split at beta +-pi/2 crossings" << std::endl;
+	}
+
+	int lod = LOD_FULL;
+	Application::AddApplicationParameter(&lod, Application::ApplicationParameterType::integer, L"-lod");
+	SetLODLevel(lod);
+
+	Application::AddApplicationParameter(&sleepTickWindow, Application::ApplicationParameterType::integer, L"-sleep");
+	if (sleepTickWindow > 0)
+	{
+		std::cout << "sleeping enabled after " << sleepTickWindow << " quiet ticks" << std::endl;
+	}
+
+	int groundContactFlag = 0;
+	Application::AddApplicationParameter(&groundContactFlag, Application::ApplicationParameterType::integer, L"-ground");
+	groundContact = groundContactFlag != 0;
+	if (groundContact)
+	{
+		std::cout << "links collide with the ground plane" << std::endl;
+	}
+
+	int worldContactFlag = 0;
+	Application::AddApplicationParameter(&worldContactFlag, Application::ApplicationParameterType::integer, L"-contact");
+	worldContact = worldContactFlag != 0;
+	if (worldContact)
+	{
+		std::cout << "links collide with the rigid body colliders" << std::endl;
+	}
 	std::cout << std::endl;
 }
@@ -0,0 +1,124 @@
+#include "MultiBody.h"
+#include "Engine/Math/EigenHelper.h"
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <algorithm>
+
+//Multi-rate stepping. Every multibody advances at its own step size and application ticks are the shared sync points:
+//a finer step substeps inside the tick, a coarser step is taken every few ticks and the links are interpolated for rendering in between.
+//Control runs once per tick, its forces are accumulated as impulses and applied as constant forces over every step of the interval.
+//Rendering interpolates between the last two completed steps, so on coarse intervals the links are drawn up to one interval behind the simulation.
+
+void sca2025::MultiBody::ScheduleSteps(const _Scalar i_tickDt)
+{
+	//control forces of this tick, taken before a pending step overwrites externalForces
+	tickForces = externalForces;
+
+	_Scalar h = stepSize > 0 ? stepSize : i_tickDt;
+	if (adaptiveStepSize > 0) h = std::min(h, adaptiveStepSize);
+	adaptiveStepSize = 0;
+
+	int substeps = 1;
+	int interval = 1;
+	if (h < i_tickDt) substeps = static_cast<int>(ceil(i_tickDt / h - 1e-9));
+	else interval = static_cast<int>(floor(h / i_tickDt + 1e-9));
+	if (lodLevel == LOD_COARSE) interval *= lodStepInterval;
+	if (interval != stepInterval)
+	{
+		ResetStepSchedule();
+		stepInterval = interval;
+	}
+
+	AccumulateControlImpulse(tickForces, i_tickDt);
+	_Scalar stepDt = i_tickDt;
+	if (stepInterval > 1)
+	{
+		pendingTime += i_tickDt;
+		pendingTickCount++;
+		if (pendingTickCount < stepInterval)
+		{
+			InterpolateRenderState((_Scalar)pendingTickCount / stepInterval);
+			return;
+		}
+		stepDt = pendingTime;
+		pendingTime = 0;
+		pendingTickCount = 0;
+		renderPosPrev = renderPosCurr;
+		renderOriPrev = renderOriCurr;
+	}
+
+	ApplyControlImpulse(stepDt);
+	dt = stepDt / substeps;
+	for (int s = 0; s < substeps; s++)
+	{
+		StepDynamics(dt);
+	}
+
+	if (stepInterval > 1)
+	{
+		SnapshotRenderState(renderPosCurr, renderOriCurr);
+		InterpolateRenderState(0);
+	}
+}
+
+void sca2025::MultiBody::ResetStepSchedule()
+{
+	//finish the pending step so that no simulation time is lost
+	if (pendingTickCount > 0)
+	{
+		ApplyControlImpulse(pendingTime);
+		dt = pendingTime;
+		StepDynamics(dt);
+	}
+	pendingTime = 0;
+	pendingTickCount = 0;
+
+	SnapshotRenderState(renderPosCurr, renderOriCurr);
+	renderPosPrev = renderPosCurr;
+	renderOriPrev = renderOriCurr;
+	InterpolateRenderState(1);
+}
+
+void sca2025::MultiBody::AccumulateControlImpulse(const std::vector<_Vector>& i_forces, const _Scalar i_dt)
+{
+	if (controlImpulses.size() != i_forces.size())
+	{
+		controlImpulses.assign(i_forces.size(), _Vector::Zero(6));
+	}
+	for (size_t i = 0; i < i_forces.size(); i++)
+	{
+		controlImpulses[i] += i_dt * i_forces[i];
+	}
+}
+
+void sca2025::MultiBody::ApplyControlImpulse(const _Scalar i_stepDt)
+{
+	stepForces.resize(controlImpulses.size());
+	for (size_t i = 0; i < controlImpulses.size(); i++)
+	{
+		stepForces[i] = controlImpulses[i] / i_stepDt;
+		controlImpulses[i].setZero();
+	}
+}
+
+void sca2025::MultiBody::SnapshotRenderState(std::vector<_Vector3>& o_pos, std::vector<_Quat>& o_ori)
+{
+	o_pos.resize(numOfLinks);
+	o_ori.resize(numOfLinks);
+	for (int i = 0; i < numOfLinks; i++)
+	{
+		o_pos[i] = pos[i];
+		o_ori[i] = Math::RotationConversion_MatToQuat(R_global[i]);
+	}
+}
+
+void sca2025::MultiBody::InterpolateRenderState(_Scalar t)
+{
+	for (int i = 0; i < numOfLinks; i++)
+	{
+		_Vector3 p = (1 - t) * renderPosPrev[i] + t * renderPosCurr[i];
+		_Quat ori = renderOriPrev[i].slerp(t, renderOriCurr[i]);
+		m_linkBodys[i]->m_State.position = Math::sVector((float)p(0), (float)p(1), (float)p(2));
+		m_linkBodys[i]->m_State.orientation = Math::ConvertEigenQuatToNativeQuat(ori);
+	}
+}
@@ -0,0 +1,131 @@
+#include "MultiBody.h"
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <algorithm>
+
+//Rollback and retry. The state is saved before every step, when the step ends close to an Euler twist singularity,
+//violates the joint limits by more than rollbackErrorThreshold or produces non-finite values, it is rolled back and redone with local substeps.
+//A retry that still fails is redone with finer substeps, up to rollbackMaxRetries times.
+
+void sca2025::MultiBody::StepDynamics(const _Scalar h)
+{
+	if (rollbackSubsteps <= 1)
+	{
+		EventLocalizedStep(h);
+		return;
+	}
+
+	SaveStepSnapshot(stepSnapshot);
+	EventLocalizedStep(h);
+	if (!StepNeedsRetry()) return;
+
+	//every retry is checked again and refined by another factor of rollbackSubsteps
+	int substeps = 1;
+	for (int retry = 0; retry < rollbackMaxRetries; retry++)
+	{
+		RestoreStepSnapshot(stepSnapshot);
+		substeps *= rollbackSubsteps;
+		_Scalar subH = h / substeps;
+		for (int s = 0; s < substeps; s++)
+		{
+			EventLocalizedStep(subH);
+		}
+		rollbackCount++;
+		if (!StepNeedsRetry()) return;
+	}
+
+	//the finest retry is kept unless it blew up, then the step is dropped
+	rollbackFailCount++;
+	if (!q.allFinite() || !qdot.allFinite()) RestoreStepSnapshot(stepSnapshot);
+}
+
+void sca2025::MultiBody::IntegrateStep(const _Scalar h)
+{
+	//the dynamics add gravity to externalForces, every attempt starts from the control forces of the interval
+	if (stepForces.size() == externalForces.size()) externalForces = stepForces;
+	if (constraintSolverMode == PBD)
+	{
+		XPBDIntegration(h);
+	}
+	else if (integrationMethod == EXPLICIT)
+	{
+		EulerIntegration(h);
+	}
+	else if (integrationMethod == RK4)
+	{
+		RK4Integration(h);
+	}
+}
+
+bool sca2025::MultiBody::StepNeedsRetry()
+{
+	if (!q.allFinite() || !qdot.allFinite()) return true;
+
+	for (int i = 0; i < numOfLinks; i++)
+	{
+		if (!IsLimitActive(i)) continue;
+		if (jointType[i] != BALL_JOINT_4D) continue;
+		if (jointRange[i].first > 0 && rollbackErrorThreshold > 0)
+		{
+			if (-ComputeSwingError(i) > rollbackErrorThreshold) return true;
+		}
+		if (jointRange[i].second > 0 && (twistMode == EULER_V2 || twistMode == EULER))
+		{
+			_Vector3 rotatedX = R_local[i] * eulerX[i];
+			_Vector3 s;
+			if (vectorFieldNum[i] == 0) s = rotatedX.cross(eulerY[i]);
+			else s = eulerY[i].cross(rotatedX);
+			_Scalar sNorm = s.norm();
+			if (sNorm < rollbackSingularityEpsilon) return true;
+			if (rollbackErrorThreshold > 0)
+			{
+				_Scalar twistError = s.dot(R_local[i] * eulerZ[i]) / sNorm - cos(jointRange[i].second);
+				if (-twistError > rollbackErrorThreshold) return true;
+			}
+		}
+	}
+	return false;
+}
+
+void sca2025::MultiBody::SaveStepSnapshot(sStepSnapshot& o_snapshot)
+{
+	o_snapshot.q = q;
+	o_snapshot.qdot = qdot;
+	o_snapshot.rel_ori = rel_ori;
+	o_snapshot.lastValidOri = lastValidOri;
+	o_snapshot.vectorFieldNum = vectorFieldNum;
+	o_snapshot.totalTwist = totalTwist;
+	o_snapshot.adaptiveStepSize = adaptiveStepSize;
+	o_snapshot.maxLimitImpulse = maxLimitImpulse;
+	if (constraintSolverMode == PBD)
+	{
+		o_snapshot.pos = pos;
+		o_snapshot.obs_ori = obs_ori;
+		o_snapshot.vel = vel;
+		o_snapshot.w_abs_world = w_abs_world;
+	}
+}
+
+void sca2025::MultiBody::RestoreStepSnapshot(sStepSnapshot& i_snapshot)
+{
+	q = i_snapshot.q;
+	qdot = i_snapshot.qdot;
+	rel_ori = i_snapshot.rel_ori;
+	lastValidOri = i_snapshot.lastValidOri;
+	vectorFieldNum = i_snapshot.vectorFieldNum;
+	totalTwist = i_snapshot.totalTwist;
+	adaptiveStepSize = i_snapshot.adaptiveStepSize;
+	maxLimitImpulse = i_snapshot.maxLimitImpulse;
+	if (constraintSolverMode == PBD)
+	{
+		pos = i_snapshot.pos;
+		obs_ori = i_snapshot.obs_ori;
+		vel = i_snapshot.vel;
+		w_abs_world = i_snapshot.w_abs_world;
+		XPBDSyncReducedCoordinates();
+	}
+	else
+	{
+		Forward();
+	}
+}
@@ -0,0 +1,353 @@
+#include "MultiBody.h"
+#include "Engine/Math/EigenHelper.h"
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <algorithm>
+
+//XPBD backend for constraintSolverMode == PBD.
+//Links are simulated in maximal coordinates (pos, obs_ori, vel, w_abs_world), joint connections and swing/twist limits
+//are enforced as compliant position level constraints, and the reduced coordinates are recovered at the end of each step.
+
+void sca2025::MultiBody::XPBDInitialization()
+{
+	xpbdPrevPos.resize(numOfLinks);
+	xpbdPrevOri.resize(numOfLinks);
+	invLocalInertiaTensors.resize(numOfLinks);
+	xpbdLambda.assign(3 * numOfLinks, 0);
+	for (int i = 0; i < numOfLinks; i++)
+	{
+		//hinge and 3D ball joints do not maintain obs_ori
+		obs_ori[i] = Math::RotationConversion_MatToQuat(R_global[i]);
+		invLocalInertiaTensors[i] = localInertiaTensors[i].inverse();
+	}
+
+	//greedy coloring, joints with the same color share no body and can be solved concurrently
+	std::vector<std::vector<int>> bodyColors(numOfLinks);
+	xpbdBatches.clear();
+	for (int i = 0; i < numOfLinks; i++)
+	{
+		int j = parentArr[i];
+		int color = 0;
+		while (std::find(bodyColors[i].begin(), bodyColors[i].end(), color) != bodyColors[i].end() ||
+			(j != -1 && std::find(bodyColors[j].begin(), bodyColors[j].end(), color) != bodyColors[j].end()))
+		{
+			color++;
+		}
+		bodyColors[i].push_back(color);
+		if (j != -1) bodyColors[j].push_back(color);
+		if (color >= static_cast<int>(xpbdBatches.size())) xpbdBatches.resize(color + 1);
+		xpbdBatches[color].push_back(i);
+	}
+	xpbdInitialized = true;
+}
+
+void sca2025::MultiBody::XPBDIntegration(const _Scalar h)
+{
+	if (!xpbdInitialized) XPBDInitialization();
+
+	_Scalar subH = h / xpbdSubsteps;
+	for (int step = 0; step < xpbdSubsteps; step++)
+	{
+		//predict unconstrained positions and orientations
+		for (int i = 0; i < numOfLinks; i++)
+		{
+			_Scalar invMass = 1.0 / Mbody[i](0, 0);
+			_Vector3 force = externalForces[i].segment(0, 3);
+			_Vector3 torque = externalForces[i].segment(3, 3);
+			if (gravity) force += Mbody[i](0, 0) * _Vector3(0.0f, -9.8f, 0.0f);
+
+			xpbdPrevPos[i] = pos[i];
+			vel[i] += subH * invMass * force;
+			pos[i] += subH * vel[i];
+
+			_Matrix3 rot = obs_ori[i].toRotationMatrix();
+			_Matrix3 inertia = rot * localInertiaTensors[i] * rot.transpose();
+			_Matrix3 invInertia = rot * invLocalInertiaTensors[i] * rot.transpose();
+			_Vector3& w = w_abs_world[i];
+			w += subH * invInertia * (torque - w.cross(inertia * w));
+
+			xpbdPrevOri[i] = obs_ori[i];
+			_Quat dq(0, w(0), w(1), w(2));
+			dq = dq * obs_ori[i];
+			obs_ori[i].coeffs() += 0.5 * subH * dq.coeffs();
+			obs_ori[i].normalize();
+		}
+
+		//solve constraints batch by batch, joints inside a batch are independent
+		std::fill(xpbdLambda.begin(), xpbdLambda.end(), 0);
+		for (size_t k = 0; k < xpbdBatches.size(); k++)
+		{
+			std::vector<int>& batch = xpbdBatches[k];
+			int batchSize = static_cast<int>(batch.size());
+#pragma omp parallel for if(batchSize >= xpbdParallelThreshold)
+			for (int b = 0; b < batchSize; b++)
+			{
+				XPBDSolveJoint(batch[b], subH);
+			}
+		}
+
+		//derive velocities
+		for (int i = 0; i < numOfLinks; i++)
+		{
+			if (jointType[i] == BALL_JOINT_4D || jointType[i] == BALL_JOINT_3D)
+			{
+				//limit multipliers are position level, divide by the substep to compare them with impulses
+				maxLimitImpulse = std::max<_Scalar>(maxLimitImpulse, std::max(abs(xpbdLambda[3 * i + 1]), abs(xpbdLambda[3 * i + 2])) / subH);
+			}
+			vel[i] = (pos[i] - xpbdPrevPos[i]) / subH;
+			_Quat dq = obs_ori[i] * xpbdPrevOri[i].conjugate();
+			w_abs_world[i] = 2.0 * dq.vec() / subH;
+			if (dq.w() < 0) w_abs_world[i] = -w_abs_world[i];
+		}
+	}
+
+	for (int i = 0; i < numOfLinks; i++)
+	{
+		vel[i] = damping * vel[i];
+		w_abs_world[i] = damping * w_abs_world[i];
+	}
+	XPBDSyncReducedCoordinates();
+}
+
+void sca2025::MultiBody::XPBDSolveJoint(int i, _Scalar h)
+{
+	if (jointType[i] == FREE_JOINT) return;
+
+	int j = parentArr[i];
+	//orientation of the parent body, the world frame for the root
+	auto parentOri = [&]() { return j == -1 ? _Quat::Identity() : obs_ori[j]; };
+
+	if (jointType[i] == HINGE_JOINT)
+	{
+		//align hinge axes
+		_Vector3 a0 = parentOri() * hingeDirLocals[i];
+		_Vector3 a1 = obs_ori[i] * hingeDirLocals[i];
+		_Vector3 corr = a0.cross(a1);
+		XPBDApplyAngularCorrection(j, i, corr, jointCompliance, xpbdLambda[3 * i + 1], h);
+	}
+
+	//joint connection
+	{
+		_Vector3 anchor0;
+		_Vector3 r0;
+		if (j == -1)
+		{
+			anchor0 = jointPos[0];
+		}
+		else
+		{
+			anchor0 = pos[j] + obs_ori[j] * uLocalsParent[i];
+		}
+		if (jointType[i] == HINGE_JOINT) anchor0 += hingeMagnitude[i] * (parentOri() * hingeDirLocals[i]);
+		if (j == -1) r0.setZero();
+		else r0 = anchor0 - pos[j];
+
+		_Vector3 r1 = obs_ori[i] * uLocalsChild[i];
+		_Vector3 anchor1 = pos[i] + r1;
+		_Vector3 corr = anchor1 - anchor0;
+		XPBDApplyPositionalCorrection(j, i, corr, r0, r1, jointCompliance, xpbdLambda[3 * i], h);
+	}
+
+	if (lodLocked[i])
+	{
+		//weld the leaf link to its parent with the relative orientation it had when it was merged
+		_Quat target = parentOri() * lodLockedOri[i];
+		_Quat dq = obs_ori[i] * target.conjugate();
+		_Vector3 corr = 2.0 * dq.vec();
+		if (dq.w() < 0) corr = -corr;
+		XPBDApplyAngularCorrection(j, i, corr, 0, xpbdLambda[3 * i + 2], h);
+		return;
+	}
+	if (jointType[i] != BALL_JOINT_4D && jointType[i] != BALL_JOINT_3D) return;
+	if (!IsLimitActive(i)) return;
+
+	//swing limit
+	if (jointRange[i].first > 0)
+	{
+		_Vector3 a0 = parentOri() * twistAxis[i];
+		_Vector3 a1 = obs_ori[i] * twistAxis[i];
+		_Vector3 n = a0.cross(a1);
+		if (n.norm() > swingEpsilon)
+		{
+			n.normalize();
+			_Vector3 corr;
+			if (XPBDLimitAngle(n, a0, a1, 0, jointRange[i].first, corr))
+			{
+				XPBDApplyAngularCorrection(j, i, corr, limitCompliance, xpbdLambda[3 * i + 1], h);
+			}
+		}
+	}
+
+	//twist limit, measured around the bisector of both twist axes
+	if (jointRange[i].second > 0)
+	{
+		_Vector3 a0 = parentOri() * twistAxis[i];
+		_Vector3 a1 = obs_ori[i] * twistAxis[i];
+		_Vector3 n = a0 + a1;
+		if (n.norm() > swingEpsilon)
+		{
+			n.normalize();
+			_Vector3 b0 = parentOri() * eulerZ[i];
+			_Vector3 b1 = obs_ori[i] * eulerZ[i];
+			b0 = (b0 - n.dot(b0) * n).normalized();
+			b1 = (b1 - n.dot(b1) * n).normalized();
+			_Vector3 corr;
+			if (XPBDLimitAngle(n, b0, b1, -jointRange[i].second, jointRange[i].second, corr))
+			{
+				XPBDApplyAngularCorrection(j, i, corr, limitCompliance, xpbdLambda[3 * i + 2], h);
+			}
+		}
+	}
+}
+
+bool sca2025::MultiBody::XPBDLimitAngle(_Vector3& n, _Vector3& a, _Vector3& b, _Scalar minAngle, _Scalar maxAngle, _Vector3& o_corr)
+{
+	//signed angle from a to b around n
+	_Scalar phi = asin(std::max<_Scalar>(-1.0, std::min<_Scalar>(1.0, a.cross(b).dot(n))));
+	if (a.dot(b) < 0) phi = M_PI - phi;
+	if (phi > M_PI) phi -= 2 * M_PI;
+	if (phi < -M_PI) phi += 2 * M_PI;
+
+	if (phi >= minAngle && phi <= maxAngle) return false;
+
+	phi = std::max(minAngle, std::min(maxAngle, phi));
+#if defined (HIGH_PRECISION_MODE)
+	_Vector3 aClamped = AngleAxisd(phi, n) * a;
+#else
+	_Vector3 aClamped = AngleAxisf(phi, n) * a;
+#endif
+	o_corr = aClamped.cross(b);
+	return true;
+}
+
+_Scalar sca2025::MultiBody::XPBDGeneralizedInverseMass(int body, _Vector3& n, _Vector3* r)
+{
+	if (body == -1) return 0;
+
+	_Vector3 dir = r ? _Vector3(r->cross(n)) : n;
+	_Vector3 dirLocal = obs_ori[body].conjugate() * dir;
+	_Scalar w = dirLocal.dot(invLocalInertiaTensors[body] * dirLocal);
+	if (r) w += 1.0 / Mbody[body](0, 0);
+	return w;
+}
+
+void sca2025::MultiBody::XPBDApplyBodyCorrection(int body, _Vector3& p, _Vector3* r)
+{
+	if (body == -1) return;
+
+	_Vector3 dw;
+	if (r)
+	{
+		pos[body] += p / Mbody[body](0, 0);
+		dw = r->cross(p);
+	}
+	else
+	{
+		dw = p;
+	}
+	dw = obs_ori[body] * (invLocalInertiaTensors[body] * (obs_ori[body].conjugate() * dw));
+	_Quat dq(0, dw(0), dw(1), dw(2));
+	dq = dq * obs_ori[body];
+	obs_ori[body].coeffs() += 0.5 * dq.coeffs();
+	obs_ori[body].normalize();
+}
+
+void sca2025::MultiBody::XPBDApplyPositionalCorrection(int b0, int b1, _Vector3& i_corr, _Vector3& r0, _Vector3& r1, _Scalar i_compliance, _Scalar& io_lambda, _Scalar h)
+{
+	_Scalar C = i_corr.norm();
+	if (C < 1e-12) return;
+	_Vector3 n = i_corr / C;
+
+	_Scalar w = XPBDGeneralizedInverseMass(b0, n, &r0) + XPBDGeneralizedInverseMass(b1, n, &r1);
+	if (w == 0) return;
+
+	_Scalar alpha = i_compliance / (h * h);
+	_Scalar dLambda = (-C - alpha * io_lambda) / (w + alpha);
+	io_lambda += dLambda;
+
+	//b0 moves along the correction, b1 against it
+	_Vector3 p = -dLambda * n;
+	XPBDApplyBodyCorrection(b0, p, &r0);
+	p = -p;
+	XPBDApplyBodyCorrection(b1, p, &r1);
+}
+
+void sca2025::MultiBody::XPBDApplyAngularCorrection(int b0, int b1, _Vector3& i_corr, _Scalar i_compliance, _Scalar& io_lambda, _Scalar h)
+{
+	_Scalar C = i_corr.norm();
+	if (C < 1e-12) return;
+	_Vector3 n = i_corr / C;
+
+	_Scalar w = XPBDGeneralizedInverseMass(b0, n, nullptr) + XPBDGeneralizedInverseMass(b1, n, nullptr);
+	if (w == 0) return;
+
+	_Scalar alpha = i_compliance / (h * h);
+	_Scalar dLambda = (-C - alpha * io_lambda) / (w + alpha);
+	io_lambda += dLambda;
+
+	_Vector3 p = -dLambda * n;
+	XPBDApplyBodyCorrection(b0, p, nullptr);
+	p = -p;
+	XPBDApplyBodyCorrection(b1, p, nullptr);
+}
+
+void sca2025::MultiBody::XPBDSyncReducedCoordinates()
+{
+	for (int i = 0; i < numOfLinks; i++)
+	{
+		int j = parentArr[i];
+		_Quat parentOri = j == -1 ? _Quat::Identity() : obs_ori[j];
+		_Quat rel = parentOri.conjugate() * obs_ori[i];
+		_Vector3 wRel = w_abs_world[i];
+		if (j != -1) wRel -= w_abs_world[j];
+
+		R_global[i] = obs_ori[i].toRotationMatrix();
+		R_local[i] = rel.toRotationMatrix();
+		if (jointType[i] == BALL_JOINT_4D)
+		{
+			rel_ori[i] = rel;
+			qdot.segment(velStartIndex[i], 3) = parentOri.conjugate() * wRel;
+		}
+		else if (jointType[i] == BALL_JOINT_3D)
+		{
+			_Vector3 r = Math::RotationConversion_QuatToVec(rel);
+			q.segment(posStartIndex[i], 3) = r;
+			//the relative angular velocity in the parent frame is J_rotation * r_dot
+			_Scalar theta = r.norm();
+			_Scalar a = Compute_a(theta);
+			_Scalar b = Compute_b(theta);
+			_Scalar c = Compute_c(theta, a);
+			J_rotation[i] = _Matrix::Identity(3, 3) + b * Math::ToSkewSymmetricMatrix(r) + c * Math::ToSkewSymmetricMatrix(r) * Math::ToSkewSymmetricMatrix(r);
+			qdot.segment(velStartIndex[i], 3) = J_rotation[i].inverse() * (parentOri.conjugate() * wRel);
+		}
+		else if (jointType[i] == FREE_JOINT)
+		{
+			rel_ori[i] = obs_ori[i];
+			q.segment(posStartIndex[i], 3) = pos[i];
+			qdot.segment(velStartIndex[i], 3) = vel[i];
+			qdot.segment(velStartIndex[i] + 3, 3) = w_abs_world[i];
+		}
+		else if (jointType[i] == HINGE_JOINT)
+		{
+			q(posStartIndex[i]) = 2.0 * atan2(rel.vec().dot(hingeDirLocals[i]), rel.w());
+			if (i > 0) hingeDirGlobals[i] = R_global[i] * hingeDirLocals[i];
+			qdot(velStartIndex[i]) = hingeDirGlobals[i].dot(wRel);
+		}
+
+		uGlobalsChild[i] = R_global[i] * uLocalsChild[i];
+		if (i > 0)
+		{
+			uGlobalsParent[i] = R_global[j] * uLocalsParent[i];
+			jointPos[i] = pos[j] + uGlobalsParent[i];
+		}
+
+		_Scalar eulerAngles[3];
+		GetEulerAngles(i, rel, eulerAngles);
+		mAlpha[i] = eulerAngles[2];
+		mBeta[i] = eulerAngles[1];
+		mGamma[i] = eulerAngles[0];
+
+		m_linkBodys[i]->m_State.position = Math::sVector((float)pos[i](0), (float)pos[i](1), (float)pos[i](2));
+		m_linkBodys[i]->m_State.orientation = Math::ConvertEigenQuatToNativeQuat(obs_ori[i]);
+	}
+}